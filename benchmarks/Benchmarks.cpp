@@ -1,3 +1,11 @@
+#include <dsp/AnalysisEngine.h>
+#include <dsp/BandWorkspace.h>
+#include <dsp/CrossoverEngine.h>
+#include <dsp/WidthStage.h>
+#include <functional>
+#include <iostream>
+#include <limits>
+
 TEST_CASE ("Boot performance")
 {
     BENCHMARK_ADVANCED ("Processor constructor")
@@ -30,3 +38,329 @@ TEST_CASE ("Boot performance")
         });
     };
 }
+
+TEST_CASE ("State save and recall")
+{
+    // Rappel d'une session : des centaines d'instances chargent leur état
+    constexpr int numStates = 1000;
+
+    PluginProcessor plugin;
+    plugin.apvts.getParameter ("WIDTH2")->setValueNotifyingHost (0.8f);
+    plugin.apvts.getParameter ("XOVER3")->setValueNotifyingHost (0.6f);
+
+    juce::MemoryBlock state;
+    plugin.getStateInformation (state);
+
+    BENCHMARK ("Save 1000 states")
+    {
+        juce::MemoryBlock destination;
+        for (int i = 0; i < numStates; ++i)
+            plugin.getStateInformation (destination);
+        return destination.getSize();
+    };
+
+    BENCHMARK ("Load 1000 states")
+    {
+        for (int i = 0; i < numStates; ++i)
+            plugin.setStateInformation (state.getData(), (int) state.getSize());
+        return plugin.getCurrentProgram();
+    };
+
+    BENCHMARK ("Switch between 2 presets 1000 times")
+    {
+        auto& bank = plugin.getPresetBank();
+        const auto other = bank.getNumPresets() > 1 ? 1 : bank.addCurrentState ("Other");
+        for (int i = 0; i < numStates; ++i)
+            bank.loadPreset (i % 2 == 0 ? 0 : other);
+        return bank.getCurrentPreset();
+    };
+}
+
+//==============================================================================
+// Débit du DSP : processBlock complet puis chaque étape seule, pour toutes les
+// tailles de bloc et fréquences d'échantillonnage courantes. Sert de référence
+// pour accepter ou refuser une optimisation et pour repérer les régressions.
+namespace
+{
+    constexpr std::array<int, 5> blockSizes { 16, 64, 256, 1024, 4096 };
+    constexpr std::array<double, 4> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+    enum class Signal { noise, sine };
+
+    const char* getName (Signal signal) { return signal == Signal::noise ? "noise" : "sine"; }
+
+    // Stéréo décorrélée : le bruit diffère entre L et R, le sinus est déphasé
+    template <typename SampleType>
+    void fill (juce::AudioBuffer<SampleType>& buffer, Signal signal, double sampleRate, juce::int64 startSample)
+    {
+        juce::Random random (startSample);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer (ch);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                if (signal == Signal::noise)
+                    data[i] = (SampleType) (0.5f * (random.nextFloat() * 2.0f - 1.0f));
+                else
+                    data[i] = (SampleType) (0.5 * std::sin (juce::MathConstants<double>::twoPi * 1000.0 * (double) (startSample + i) / sampleRate + 0.3 * ch));
+            }
+        }
+    }
+
+    // Une étape du traitement, préparée pour une fréquence et une taille de bloc
+    template <typename SampleType>
+    struct Stage
+    {
+        const char* name;
+        std::function<void (double sampleRate, int blockSize)> prepare;
+        std::function<void (juce::AudioBuffer<SampleType>&)> process;
+    };
+
+    // Crossover et bandes déjà séparées, dans une précision
+    template <typename SampleType>
+    struct SplitBands
+    {
+        CrossoverEngine<SampleType> crossover;
+        BandWorkspace<SampleType> workspace;
+        typename CrossoverEngine<SampleType>::BandBlocks blocks;
+
+        void prepare (double sampleRate, int blockSize)
+        {
+            crossover.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+            workspace.prepare (2, blockSize);
+            for (int b = 0; b < BandCount::max; ++b)
+                blocks[(size_t) b] = workspace.getBand (b, 2, blockSize);
+        }
+
+        template <size_t numBands>
+        typename WidthStage<SampleType>::template BandPointers<numBands> pointers (int channel) const
+        {
+            typename WidthStage<SampleType>::template BandPointers<numBands> result;
+            for (size_t b = 0; b < numBands; ++b)
+                result[b] = blocks[b].getChannelPointer ((size_t) channel);
+            return result;
+        }
+    };
+
+    // Toutes les étapes partagent les mêmes objets, préparés à chaque configuration
+    struct Stages
+    {
+        static constexpr size_t numBands = 4;
+
+        PluginProcessor plugin, doublePlugin;
+        juce::MidiBuffer midi;
+
+        SplitBands<float> bands;
+        SplitBands<double> doubleBands;
+        WidthStage<float> width, monoWidth;
+        WidthStage<double> doubleWidth;
+        AnalysisEngine analysis;
+
+        Stages()
+        {
+            analysis.setActive (true);
+            doublePlugin.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+        }
+
+        ~Stages() { analysis.setActive (false); }
+
+        static std::array<float, BandCount::max> getWidths()
+        {
+            std::array<float, BandCount::max> widths;
+            widths.fill (1.0f);
+            widths[0] = 0.0f;
+            widths[3] = 1.5f;
+            return widths;
+        }
+
+        std::vector<Stage<float>> get()
+        {
+            const auto widths = getWidths();
+
+            return {
+                { "processBlock",
+                    [this] (double sampleRate, int blockSize) {
+                        plugin.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+                        plugin.prepareToPlay (sampleRate, blockSize);
+                    },
+                    [this] (juce::AudioBuffer<float>& buffer) { plugin.processBlock (buffer, midi); } },
+
+                { "band split",
+                    [this] (double sampleRate, int blockSize) { bands.prepare (sampleRate, blockSize); },
+                    [this] (juce::AudioBuffer<float>& buffer) { bands.crossover.process (juce::dsp::AudioBlock<float> (buffer), bands.blocks); } },
+
+                // Mode SPLIT_MODE "Side only" : le mid ne passe que par le passe-tout
+                { "side-only split",
+                    [this] (double sampleRate, int blockSize) { bands.prepare (sampleRate, blockSize); },
+                    [this] (juce::AudioBuffer<float>& buffer) { bands.crossover.processSideOnly<numBands> (juce::dsp::AudioBlock<float> (buffer), bands.blocks.data()); } },
+
+                // Largeur et sommation ne font qu'une passe (WidthKernel) : on la mesure
+                // sur des bandes déjà séparées
+                { "width + summation",
+                    [this, widths] (double sampleRate, int blockSize) {
+                        bands.prepare (sampleRate, blockSize);
+                        width.prepare (sampleRate, widths);
+                    },
+                    [this] (juce::AudioBuffer<float>& buffer) {
+                        width.process<numBands> (bands.pointers<numBands> (0), bands.pointers<numBands> (1), buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+                    } },
+
+                // Même passe avec le passe-haut des basses mono sur le side
+                { "width + mono bass",
+                    [this, widths] (double sampleRate, int blockSize) {
+                        bands.prepare (sampleRate, blockSize);
+                        monoWidth.setMonoBass (true, 120.0f);
+                        monoWidth.prepare (sampleRate, widths);
+                    },
+                    [this] (juce::AudioBuffer<float>& buffer) {
+                        monoWidth.process<numBands> (bands.pointers<numBands> (0), bands.pointers<numBands> (1), buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+                    } },
+
+                // Sommation seule (chemin mono de processBands), pour comparaison
+                { "summation only",
+                    [this] (double sampleRate, int blockSize) { bands.prepare (sampleRate, blockSize); },
+                    [this] (juce::AudioBuffer<float>& buffer) {
+                        juce::dsp::AudioBlock<float> block (buffer);
+                        block.copyFrom (bands.blocks[0].getSubBlock (0, (size_t) buffer.getNumSamples()));
+                        for (size_t b = 1; b < numBands; ++b)
+                            block.add (bands.blocks[b].getSubBlock (0, (size_t) buffer.getNumSamples()));
+                    } },
+
+                { "scope push",
+                    [this] (double sampleRate, int) { analysis.prepare (sampleRate); },
+                    [this] (juce::AudioBuffer<float>& buffer) { analysis.push (buffer); } },
+            };
+        }
+
+        // Les mêmes étapes en double précision, à comparer aux lignes float
+        std::vector<Stage<double>> getDouble()
+        {
+            const auto widths = getWidths();
+
+            return {
+                { "processBlock (double)",
+                    [this] (double sampleRate, int blockSize) {
+                        doublePlugin.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+                        doublePlugin.prepareToPlay (sampleRate, blockSize);
+                    },
+                    [this] (juce::AudioBuffer<double>& buffer) { doublePlugin.processBlock (buffer, midi); } },
+
+                { "band split (double)",
+                    [this] (double sampleRate, int blockSize) { doubleBands.prepare (sampleRate, blockSize); },
+                    [this] (juce::AudioBuffer<double>& buffer) { doubleBands.crossover.process (juce::dsp::AudioBlock<double> (buffer), doubleBands.blocks); } },
+
+                { "width (double)",
+                    [this, widths] (double sampleRate, int blockSize) {
+                        doubleBands.prepare (sampleRate, blockSize);
+                        doubleWidth.prepare (sampleRate, widths);
+                    },
+                    [this] (juce::AudioBuffer<double>& buffer) {
+                        doubleWidth.process<numBands> (doubleBands.pointers<numBands> (0), doubleBands.pointers<numBands> (1), buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+                    } },
+            };
+        }
+    };
+
+    // Meilleur de plusieurs passes sur une seconde de signal, en ns par échantillon
+    template <typename SampleType>
+    double measureNanosecondsPerSample (const Stage<SampleType>& stage, Signal signal, double sampleRate, int blockSize)
+    {
+        stage.prepare (sampleRate, blockSize);
+
+        const int numBlocks = juce::jmax (1, (int) sampleRate / blockSize);
+        juce::AudioBuffer<SampleType> buffer (2, blockSize);
+        juce::AudioBuffer<SampleType> input (2, blockSize * numBlocks);
+        fill (input, signal, sampleRate, 0);
+
+        double best = std::numeric_limits<double>::max();
+
+        for (int pass = 0; pass < 5; ++pass)
+        {
+            juce::int64 ticks = 0;
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.copyFrom (ch, 0, input, ch, block * blockSize, blockSize);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                stage.process (buffer);
+                ticks += juce::Time::getHighResolutionTicks() - start;
+            }
+
+            best = juce::jmin (best, juce::Time::highResolutionTicksToSeconds (ticks));
+        }
+
+        return best * 1.0e9 / (double) (numBlocks * blockSize);
+    }
+
+    template <typename SampleType>
+    void benchmarkStages (const std::vector<Stage<SampleType>>& stageList)
+    {
+        for (auto& stage : stageList)
+        {
+            for (auto sampleRate : sampleRates)
+            {
+                for (auto blockSize : blockSizes)
+                {
+                    for (auto signal : { Signal::noise, Signal::sine })
+                    {
+                        stage.prepare (sampleRate, blockSize);
+
+                        juce::AudioBuffer<SampleType> buffer (2, blockSize);
+                        fill (buffer, signal, sampleRate, 0);
+
+                        const auto name = juce::String (stage.name) + ", " + getName (signal) + ", " + juce::String (sampleRate / 1000.0, 1) + " kHz, " + juce::String (blockSize) + " samples";
+                        BENCHMARK (name.toStdString())
+                        {
+                            stage.process (buffer);
+                            return buffer.getSample (0, 0);
+                        };
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename SampleType>
+    void reportStages (const std::vector<Stage<SampleType>>& stageList)
+    {
+        for (auto& stage : stageList)
+            for (auto signal : { Signal::noise, Signal::sine })
+                for (auto sampleRate : sampleRates)
+                    for (auto blockSize : blockSizes)
+                    {
+                        const auto nanoseconds = measureNanosecondsPerSample (stage, signal, sampleRate, blockSize);
+                        const auto realtimeFactor = 1.0e9 / (nanoseconds * sampleRate);
+
+                        std::cout << juce::String (stage.name).paddedRight (' ', 24)
+                                  << juce::String (getName (signal)).paddedRight (' ', 8)
+                                  << juce::String ((int) sampleRate).paddedLeft (' ', 9)
+                                  << juce::String (blockSize).paddedLeft (' ', 7)
+                                  << juce::String (nanoseconds, 2).paddedLeft (' ', 11)
+                                  << juce::String (realtimeFactor, 1).paddedLeft (' ', 11) << "\n";
+                    }
+    }
+}
+
+TEST_CASE ("DSP throughput")
+{
+    Stages stages;
+    benchmarkStages (stages.get());
+    benchmarkStages (stages.getDouble());
+}
+
+// Tableau lisible en CI : ns par échantillon (stéréo) et facteur temps réel
+// (durée du signal / temps de calcul, > 1 signifie plus rapide que le temps réel).
+// Les étapes en double suivent, pour comparer les deux précisions.
+TEST_CASE ("DSP throughput report")
+{
+    Stages stages;
+
+    std::cout << "\nstage                   signal  rate (Hz)  block  ns/sample  RT factor\n";
+    reportStages (stages.get());
+    reportStages (stages.getDouble());
+    std::cout << std::flush;
+}
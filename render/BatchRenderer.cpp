@@ -0,0 +1,183 @@
+#include "BatchRenderer.h"
+#include <atomic>
+
+int BatchRenderer::render (const juce::Array<juce::File>& inputs, const Logger& log)
+{
+    formatManager.registerBasicFormats();
+
+    const int numWorkers = juce::jlimit (1, juce::jmax (1, inputs.size()), settings.numThreads);
+
+    // Un processeur par thread, créés ici : l'apvts démarre un Timer
+    std::vector<std::unique_ptr<PluginProcessor>> processors;
+    for (int w = 0; w < numWorkers; ++w)
+    {
+        auto plugin = std::make_unique<PluginProcessor>();
+        if (const auto result = configure (*plugin); result.failed())
+        {
+            log (result.getErrorMessage());
+            return inputs.size();
+        }
+
+        processors.push_back (std::move (plugin));
+    }
+
+    juce::CriticalSection logLock;
+    const auto logSafely = [&] (const juce::String& message) {
+        const juce::ScopedLock sl (logLock);
+        log (message);
+    };
+
+    std::atomic<int> nextInput { 0 };
+    std::atomic<int> numFailures { 0 };
+
+    // Le dernier job à finir réveille le thread message
+    std::atomic<int> numRunningJobs { numWorkers };
+    juce::WaitableEvent allJobsFinished;
+
+    // Chaque thread prend le fichier suivant dès qu'il a fini le sien
+    juce::ThreadPool pool (numWorkers);
+    for (auto& processor : processors)
+    {
+        pool.addJob ([&, plugin = processor.get()] {
+            for (int index = nextInput++; index < inputs.size(); index = nextInput++)
+            {
+                const auto& input = inputs.getReference (index);
+                const auto output = getOutputFile (input);
+                const auto start = juce::Time::getMillisecondCounterHiRes();
+                const auto result = renderFile (*plugin, input, output);
+
+                if (result.failed())
+                {
+                    ++numFailures;
+                    logSafely (input.getFullPathName() + ": " + result.getErrorMessage());
+                }
+                else
+                {
+                    const auto seconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+                    logSafely (output.getFullPathName() + " (" + juce::String (seconds, 2) + " s)");
+                }
+            }
+
+            if (--numRunningJobs == 0)
+                allJobsFinished.signal();
+
+            return juce::ThreadPoolJob::jobHasFinished;
+        });
+    }
+
+    allJobsFinished.wait (-1);
+
+    return numFailures.load();
+}
+
+juce::Result BatchRenderer::configure (PluginProcessor& plugin) const
+{
+    if (settings.stateFile != juce::File())
+    {
+        juce::MemoryBlock state;
+        if (! settings.stateFile.loadFileAsData (state))
+            return juce::Result::fail ("Cannot read " + settings.stateFile.getFullPathName());
+
+        plugin.setStateInformation (state.getData(), (int) state.getSize());
+    }
+
+    for (auto& [id, value] : settings.parameters)
+    {
+        auto* parameter = plugin.apvts.getParameter (id);
+        if (parameter == nullptr)
+            return juce::Result::fail ("Unknown parameter " + id);
+
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    return juce::Result::ok();
+}
+
+bool BatchRenderer::isRenderedFile (const juce::File& file) const
+{
+    return settings.outputSuffix.isNotEmpty() && file.getFileNameWithoutExtension().endsWith (settings.outputSuffix);
+}
+
+juce::File BatchRenderer::getOutputFile (const juce::File& input) const
+{
+    const auto directory = settings.outputDirectory == juce::File() ? input.getParentDirectory() : settings.outputDirectory;
+    return directory.getChildFile (input.getFileNameWithoutExtension() + settings.outputSuffix + input.getFileExtension());
+}
+
+std::unique_ptr<juce::AudioFormatReader> BatchRenderer::openReader (const juce::File& input)
+{
+    // Mappage mémoire : pas de copie intermédiaire, le système lit à la demande
+    if (auto* format = formatManager.findFormatForFileExtension (input.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (input));
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return mapped;
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader> (formatManager.createReaderFor (input));
+}
+
+juce::Result BatchRenderer::renderFile (PluginProcessor& plugin, const juce::File& input, const juce::File& output)
+{
+    // Suffixe vide sans --output : la sortie écraserait l'entrée
+    if (output == input)
+        return juce::Result::fail ("the output would overwrite the input");
+
+    auto reader = openReader (input);
+    if (reader == nullptr)
+        return juce::Result::fail ("unsupported or unreadable file");
+
+    const int numChannels = (int) reader->numChannels;
+    if (numChannels < 1 || numChannels > 2)
+        return juce::Result::fail ("only mono and stereo files are supported");
+
+    auto* format = formatManager.findFormatForFileExtension (output.getFileExtension());
+    if (format == nullptr)
+        return juce::Result::fail ("no writer for " + output.getFileExtension());
+
+    output.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream (output.createOutputStream (1 << 20));
+    if (stream == nullptr)
+        return juce::Result::fail ("cannot write " + output.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), reader->sampleRate, (unsigned int) numChannels, (int) reader->bitsPerSample, reader->metadataValues, 0));
+    if (writer == nullptr)
+        return juce::Result::fail ("cannot create a " + format->getFormatName() + " writer");
+
+    stream.release(); // appartient maintenant au writer
+
+    // Non temps réel avant prepareToPlay : le suréchantillonnage de rendu s'applique
+    const int blockSize = settings.blockSize;
+    plugin.setPlayConfigDetails (numChannels, numChannels, reader->sampleRate, blockSize);
+    plugin.setNonRealtime (true);
+    plugin.prepareToPlay (reader->sampleRate, blockSize);
+
+    // La latence (suréchantillonnage, FIR) est compensée : on jette le début de la
+    // sortie et on pousse autant de silence après la fin de l'entrée
+    const juce::int64 latency = plugin.getLatencySamples();
+    const juce::int64 length = reader->lengthInSamples;
+
+    juce::AudioBuffer<float> buffer (numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    for (juce::int64 position = 0; position < length + latency; position += blockSize)
+    {
+        const int numSamples = (int) juce::jmin ((juce::int64) blockSize, length + latency - position);
+        const int numToRead = (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples, length - position);
+
+        buffer.setSize (numChannels, numSamples, false, false, true);
+        buffer.clear();
+
+        if (numToRead > 0 && ! reader->read (&buffer, 0, numToRead, position, true, numChannels > 1))
+            return juce::Result::fail ("read error");
+
+        plugin.processBlock (buffer, midi);
+
+        const int skip = (int) juce::jlimit ((juce::int64) 0, (juce::int64) numSamples, latency - position);
+        if (skip < numSamples && ! writer->writeFromAudioSampleBuffer (buffer, skip, numSamples - skip))
+            return juce::Result::fail ("write error");
+    }
+
+    plugin.releaseResources();
+    return juce::Result::ok();
+}
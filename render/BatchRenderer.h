@@ -0,0 +1,53 @@
+#pragma once
+
+#include <PluginProcessor.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Rendu hors ligne de fichiers WAV/AIFF mono ou stéréo avec le DSP du plugin :
+// chaque fichier passe par PluginProcessor::processBlock (séparation en bandes,
+// largeur, suréchantillonnage de rendu), en mode non temps réel.
+//
+// La lecture se fait par mappage mémoire quand le format le permet (sinon par
+// flux), l'écriture par un flux bufferisé, en blocs de blockSize échantillons.
+// Les fichiers sont répartis entre numThreads threads, chacun avec son propre
+// processeur.
+struct RenderSettings
+{
+    juce::File stateFile;                                // état binaire (getStateInformation), optionnel
+    std::vector<std::pair<juce::String, float>> parameters; // appliqués après l'état, dans leur plage naturelle
+    juce::File outputDirectory;                          // vide : à côté de l'entrée
+    juce::String outputSuffix { "_sr23" };
+    int blockSize = 65536;
+    int numThreads = juce::SystemStats::getNumCpus();
+};
+
+class BatchRenderer
+{
+public:
+    using Logger = std::function<void (const juce::String&)>;
+
+    explicit BatchRenderer (RenderSettings settingsToUse) : settings (std::move (settingsToUse)) {}
+
+    // Thread message : crée et configure les processeurs avant de lancer les threads.
+    // Retourne le nombre de fichiers en échec.
+    int render (const juce::Array<juce::File>& inputs, const Logger& log);
+
+    // Applique l'état et les paramètres de settings au processeur
+    juce::Result configure (PluginProcessor& plugin) const;
+
+    // Vrai si le nom se termine par outputSuffix : sortie d'un rendu précédent
+    bool isRenderedFile (const juce::File& file) const;
+
+    juce::File getOutputFile (const juce::File& input) const;
+
+    juce::Result renderFile (PluginProcessor& plugin, const juce::File& input, const juce::File& output);
+
+private:
+    RenderSettings settings;
+    // Rempli avant le lancement des threads, qui ne font ensuite que le lire
+    juce::AudioFormatManager formatManager;
+
+    std::unique_ptr<juce::AudioFormatReader> openReader (const juce::File& input);
+};
@@ -0,0 +1,161 @@
+#include "BatchRenderer.h"
+#include <iostream>
+
+// SR23Render : rendu par lots de fichiers WAV/AIFF avec le DSP du plugin, sans DAW.
+//
+//   SR23Render --set WIDTH2=1.4 --set XOVER1=150 --output rendered stems/*.wav
+//   SR23Render --state master.sr23 --jobs 4 stems/
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: SR23Render [options] <files or folders>\n"
+                     "\n"
+                     "  --state <file>        load a state saved with --write-state (or by the plugin)\n"
+                     "  --set <ID>=<value>    set a parameter in its natural range, e.g. WIDTH2=1.4 (repeatable)\n"
+                     "  --output <folder>     write the results there (default: next to each input)\n"
+                     "  --suffix <text>       appended to the output file names (default: _sr23);\n"
+                     "                        inputs whose name already ends with it are skipped\n"
+                     "  --jobs <n>            files rendered in parallel (default: number of cores)\n"
+                     "  --block <n>           samples per processBlock call (default: 65536)\n"
+                     "  --write-state <file>  save the resulting parameters as a state file\n"
+                     "  --list-parameters     print the parameter IDs and ranges\n";
+    }
+
+    void listParameters()
+    {
+        PluginProcessor plugin;
+        for (auto* parameter : plugin.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter))
+                std::cout << ranged->getParameterID() << "  " << ranged->getName (64) << "  ["
+                          << ranged->getNormalisableRange().start << ", " << ranged->getNormalisableRange().end << "]  default "
+                          << ranged->convertFrom0to1 (ranged->getDefaultValue()) << "\n";
+    }
+
+    // Un dossier donne ses fichiers audio (sans descendre dans les sous-dossiers)
+    void addInputs (const juce::File& file, juce::Array<juce::File>& inputs)
+    {
+        if (file.isDirectory())
+            inputs.addArray (file.findChildFiles (juce::File::findFiles, false, "*.wav;*.aif;*.aiff"));
+        else
+            inputs.add (file);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    // Le processeur (apvts) a besoin d'un MessageManager
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList arguments (argc, argv);
+    RenderSettings settings;
+    juce::File stateToWrite;
+    juce::Array<juce::File> inputs;
+
+    for (int i = 0; i < arguments.size(); ++i)
+    {
+        const auto& argument = arguments[i];
+        const auto hasValue = i + 1 < arguments.size();
+        const auto next = [&] { return arguments[++i].text; };
+
+        if (argument == "--help" || argument == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+
+        if (argument == "--list-parameters")
+        {
+            listParameters();
+            return 0;
+        }
+
+        if (argument.isLongOption() && ! hasValue)
+        {
+            std::cerr << "Missing value after " << argument.text << "\n";
+            return 1;
+        }
+
+        if (argument == "--state")
+            settings.stateFile = juce::File::getCurrentWorkingDirectory().getChildFile (next());
+        else if (argument == "--set")
+        {
+            const auto assignment = next();
+            if (! assignment.containsChar ('='))
+            {
+                std::cerr << "Expected ID=value, got " << assignment << "\n";
+                return 1;
+            }
+
+            settings.parameters.emplace_back (assignment.upToFirstOccurrenceOf ("=", false, false).trim(),
+                assignment.fromFirstOccurrenceOf ("=", false, false).getFloatValue());
+        }
+        else if (argument == "--output")
+            settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (next());
+        else if (argument == "--suffix")
+            settings.outputSuffix = next();
+        else if (argument == "--jobs")
+            settings.numThreads = juce::jmax (1, next().getIntValue());
+        else if (argument == "--block")
+            settings.blockSize = juce::jlimit (64, 1 << 20, next().getIntValue());
+        else if (argument == "--write-state")
+            stateToWrite = juce::File::getCurrentWorkingDirectory().getChildFile (next());
+        else if (argument.isOption())
+        {
+            std::cerr << "Unknown option " << argument.text << "\n";
+            printUsage();
+            return 1;
+        }
+        else
+            addInputs (argument.resolveAsFile(), inputs);
+    }
+
+    BatchRenderer renderer (settings);
+
+    if (stateToWrite != juce::File())
+    {
+        PluginProcessor plugin;
+        if (const auto result = renderer.configure (plugin); result.failed())
+        {
+            std::cerr << result.getErrorMessage() << "\n";
+            return 1;
+        }
+
+        juce::MemoryBlock state;
+        plugin.getStateInformation (state);
+        if (! stateToWrite.replaceWithData (state.getData(), state.getSize()))
+        {
+            std::cerr << "Cannot write " << stateToWrite.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    if (inputs.isEmpty())
+    {
+        if (stateToWrite == juce::File())
+            printUsage();
+
+        return 0;
+    }
+
+    // Relancer sur le même dossier ne rend pas une seconde fois foo_sr23.wav en foo_sr23_sr23.wav
+    inputs.removeIf ([&] (const juce::File& input) {
+        if (! renderer.isRenderedFile (input))
+            return false;
+
+        std::cout << "Skipping " << input.getFullPathName() << " (already rendered)" << std::endl;
+        return true;
+    });
+
+    if (inputs.isEmpty())
+        return 0;
+
+    if (settings.outputDirectory != juce::File() && ! settings.outputDirectory.createDirectory())
+    {
+        std::cerr << "Cannot create " << settings.outputDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    const auto numFailures = renderer.render (inputs, [] (const juce::String& message) { std::cout << message << std::endl; });
+    return numFailures == 0 ? 0 : 1;
+}
@@ -7,39 +7,79 @@ PluginEditor::PluginEditor (PluginProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor(p), processorRef (p)
 {
 
-    for (auto* s : { &widthSlider1, &widthSlider2, &widthSlider3, &widthSlider4 })
+    for (size_t b = 0; b < widthSliders.size(); ++b)
     {
-        s->setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
-        s->setTextBoxStyle (juce::Slider::TextBoxBelow, false, 60, 20);
-        s->setLookAndFeel (&customSlider);
-        addAndMakeVisible (*s);
-    }
+        auto& s = widthSliders[b];
+        s.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
+        s.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 60, 20);
+        s.setLookAndFeel (&customSlider);
+        addChildComponent (s);
 
-    widthAttachment1 = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (audioProcessor.apvts, "WIDTH1", widthSlider1);
-    widthAttachment2 = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (audioProcessor.apvts, "WIDTH2", widthSlider2);
-    widthAttachment3 = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (audioProcessor.apvts, "WIDTH3", widthSlider3);
-    widthAttachment4 = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (audioProcessor.apvts, "WIDTH4", widthSlider4);
+        widthAttachments[b] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment> (audioProcessor.apvts, "WIDTH" + juce::String (b + 1), s);
+    }
 
+    for (auto& meter : bandMeters)
+        addChildComponent (meter);
 
     addAndMakeVisible(stereoScope);
     
-    multibandWidget.setBufferToDisplay (&processorRef.getScopeBuffer(), &processorRef.getScopeBufferMutex());
+    processorRef.getAnalysisEngine().setActive (true);
+    multibandWidget.setAnalysisEngine (&processorRef.getAnalysisEngine());
+
+    auto& apvts = processorRef.apvts;
+    std::array<juce::RangedAudioParameter*, BandCount::maxCrossovers> crossoverParameters;
+    for (size_t i = 0; i < crossoverParameters.size(); ++i)
+        crossoverParameters[i] = apvts.getParameter ("XOVER" + juce::String (i + 1));
+
+    multibandWidget.attachToParameters (crossoverParameters);
     addAndMakeVisible (multibandWidget);
 
+#if SR23_PERFORMANCE_MONITOR
+    performanceButton.setClickingTogglesState (true);
+    performanceButton.onClick = [this] { performanceOverlay.setVisible (performanceButton.getToggleState()); };
+    addAndMakeVisible (performanceButton);
+
+    performanceOverlay.onReset = [this] { processorRef.resetPerformanceStatistics(); };
+    addChildComponent (performanceOverlay);
+#endif
+
 
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (800, 400);
+    setSize (800, 440);
+
+    // Après setSize : le changement du nombre de bandes refait la mise en page.
+    // Le choix "2".."8" pilote les sliders visibles et les séparateurs du widget
+    numBandsAttachment = std::make_unique<juce::ParameterAttachment> (*processorRef.apvts.getParameter ("BANDS"), [this] (float choice) {
+        setNumBands (BandCount::min + juce::roundToInt (choice));
+    });
+    numBandsAttachment->sendInitialUpdate();
 
-    startTimer (60);
+    frameScheduler->addClient (*this, *this);
 }
 
 PluginEditor::~PluginEditor()
 {
-    widthSlider1.setLookAndFeel (nullptr);
-    widthSlider2.setLookAndFeel (nullptr);
-    widthSlider3.setLookAndFeel (nullptr);
-    widthSlider4.setLookAndFeel (nullptr);
+    frameScheduler->removeClient (*this);
+    numBandsAttachment.reset();
+    processorRef.getAnalysisEngine().setActive (false);
+
+    for (auto& slider : widthSliders)
+        slider.setLookAndFeel (nullptr);
+}
+
+void PluginEditor::setNumBands (int newNumBands)
+{
+    numBands = newNumBands;
+
+    for (size_t b = 0; b < widthSliders.size(); ++b)
+    {
+        widthSliders[b].setVisible ((int) b < numBands);
+        bandMeters[b].setVisible ((int) b < numBands);
+    }
+
+    multibandWidget.setNumBands (numBands);
+    resized();
 }
 
 void PluginEditor::paint (juce::Graphics& g)
@@ -53,23 +93,56 @@ void PluginEditor::resized()
     // layout the positions of your child components here
     auto area = getLocalBounds();
 
-    int sliderSize = 80;
+    // 100 px par bande jusqu'à 7 bandes, resserré au-delà pour tenir en largeur
+    int spacing = juce::jmin (100, (getWidth() - 40) / numBands);
+    int sliderSize = juce::jmin (80, spacing - 10);
     int y = 300;
 
-    widthSlider1.setBounds (30, y, sliderSize, sliderSize);
-    widthSlider2.setBounds (130, y, sliderSize, sliderSize);
-    widthSlider3.setBounds (230, y, sliderSize, sliderSize);
-    widthSlider4.setBounds (330, y, sliderSize, sliderSize);
+    for (size_t b = 0; b < (size_t) numBands; ++b)
+    {
+        widthSliders[b].setBounds (30 + spacing * (int) b, y, sliderSize, sliderSize);
+        bandMeters[b].setBounds (30 + spacing * (int) b, y + sliderSize + 4, sliderSize, 48);
+    }
+
     // StereoScope a droit
     stereoScope.setBounds (200, 100, 180, 180);
     multibandWidget.setBounds (10, 10, getWidth() - 20, 140);
 
+#if SR23_PERFORMANCE_MONITOR
+    performanceButton.setBounds (getWidth() - 54, getHeight() - 28, 44, 20);
+    performanceOverlay.setBounds (getWidth() - 330, getHeight() - 150, 320, 116);
+#endif
+
 }
 
-void PluginEditor::timerCallback()
+void PluginEditor::frameTick()
 {
-    std::scoped_lock<std::mutex> lock (audioProcessor.getScopeBufferMutex());
-    stereoScope.setAudioBuffer (&audioProcessor.getScopeBuffer());
-    multibandWidget.setBufferToDisplay (&audioProcessor.getScopeBuffer(), &audioProcessor.getScopeBufferMutex());
-    repaint();
+#if SR23_PERFORMANCE_MONITOR
+    if (performanceOverlay.isVisible())
+        performanceOverlay.setSnapshot (audioProcessor.getPerformanceMonitor().getSnapshot());
+#endif
+
+    // Entrée silencieuse : l'analyse ne publie plus rien et les mesures sont au
+    // repos. Une dernière trame est servie au passage au silence ; seule la
+    // rémanence du scope continue ensuite, jusqu'à s'éteindre.
+    auto& analysisEngine = audioProcessor.getAnalysisEngine();
+    const bool silent = analysisEngine.isSilent();
+    if (silent && wasSilent)
+    {
+        if (stereoScope.isPhosphorLit())
+            stereoScope.updateScope();
+
+        return;
+    }
+
+    wasSilent = silent;
+
+    for (size_t b = 0; b < (size_t) numBands; ++b)
+        bandMeters[b].setReading (audioProcessor.getStereoMeters().getReading (b));
+
+    // Chaque composant redessine lui-même sa zone modifiée : le fond de l'éditeur
+    // n'est recomposé que sous ces zones
+    multibandWidget.updateSpectrum();
+    stereoScope.setScopeWindow (&analysisEngine.acquireScopeWindow());
+    stereoScope.updateScope();
 }
\ No newline at end of file
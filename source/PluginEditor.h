@@ -4,11 +4,15 @@
 #include "PluginProcessor.h"
 #include "StereoScope.h"
 #include "CustomSlider.h"
+#include "components/BandMeter.h"
+#include "components/FrameScheduler.h"
 #include "components/MultibandWidget.h"
+#include "components/PerformanceOverlay.h"
 #include "melatonin_inspector/melatonin_inspector.h"
 
 //==============================================================================
-class PluginEditor : public juce::AudioProcessorEditor, public juce::Timer
+class PluginEditor : public juce::AudioProcessorEditor,
+                     private FrameScheduler::Client
 {
 public:
     explicit PluginEditor (PluginProcessor&);
@@ -17,7 +21,6 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
-    void timerCallback() override;
 
 private:
     // This reference is provided as a quick way for your editor to
@@ -25,14 +28,33 @@ private:
     PluginProcessor& audioProcessor;
     PluginProcessor& processorRef;
 
-    juce::Slider widthSlider1, widthSlider2, widthSlider3, widthSlider4;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> widthAttachment1, widthAttachment2, widthAttachment3, widthAttachment4;
+    // Un slider et une mesure par bande possible ; seuls les numBands premiers sont visibles
+    std::array<juce::Slider, BandCount::max> widthSliders;
+    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>, BandCount::max> widthAttachments;
+
+    // Mesures stéréo de chaque bande, sous les sliders de largeur
+    std::array<BandMeter, BandCount::max> bandMeters;
+
+    int numBands = 4;
+    std::unique_ptr<juce::ParameterAttachment> numBandsAttachment;
+    void setNumBands (int newNumBands);
     
+    // Une seule horloge d'affichage pour tous les éditeurs ouverts dans le processus
+    juce::SharedResourcePointer<FrameScheduler> frameScheduler;
+    bool wasSilent = false;
+    void frameTick() override;
+
     CustomSlider customSlider;
     StereoScope stereoScope;
     //SpectrumDisplay spectrum;
     //BandSplitterComponent bandSplitter;
     MultibandWidget multibandWidget;
+
+#if SR23_PERFORMANCE_MONITOR
+    // Charge du thread audio, masquée par défaut
+    juce::TextButton performanceButton { "CPU" };
+    PerformanceOverlay performanceOverlay;
+#endif
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginEditor)
 };
\ No newline at end of file
@@ -13,45 +13,208 @@ PluginProcessor::PluginProcessor()
               ),
       apvts (*this, nullptr, "Parameters", createParameters())
 {
-    scopeBuffer.setSize (getTotalNumOutputChannels(), scopeBufferSize);
+    for (size_t i = 0; i < widthParameters.size(); ++i)
+        widthParameters[i] = apvts.getRawParameterValue ("WIDTH" + juce::String (i + 1));
+
+    for (size_t i = 0; i < crossoverParameters.size(); ++i)
+        crossoverParameters[i] = apvts.getRawParameterValue ("XOVER" + juce::String (i + 1));
+
+    numBandsParameter = apvts.getRawParameterValue ("BANDS");
+    slopeParameter = apvts.getRawParameterValue ("SLOPE");
+    crossoverModeParameter = apvts.getRawParameterValue ("CROSSOVER_MODE");
+    oversamplingParameter = apvts.getRawParameterValue ("OVERSAMPLING");
+    renderOversamplingParameter = apvts.getRawParameterValue ("OVERSAMPLING_RENDER");
+    monoBassParameter = apvts.getRawParameterValue ("MONO_BASS");
+    monoBelowParameter = apvts.getRawParameterValue ("MONO_BELOW");
+    monoSafetyParameter = apvts.getRawParameterValue ("MONO_SAFETY");
+    splitModeParameter = apvts.getRawParameterValue ("SPLIT_MODE");
+
+    presetBank.addCurrentState ("Default");
 }
 PluginProcessor::~PluginProcessor()
 {
+    pendingChangesPoller->removeClient (*this);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameters()
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
-    params.push_back (std::make_unique<juce::AudioParameterFloat> ("WIDTH1", "Width Band 1", 0.0f, 2.0f, 1.0f));
-    params.push_back (std::make_unique<juce::AudioParameterFloat> ("WIDTH2", "Width Band 2", 0.0f, 2.0f, 1.0f));
-    params.push_back (std::make_unique<juce::AudioParameterFloat> ("WIDTH3", "Width Band 3", 0.0f, 2.0f, 1.0f));
-    params.push_back (std::make_unique<juce::AudioParameterFloat> ("WIDTH4", "Width Band 4", 0.0f, 2.0f, 1.0f));
+    // Nombre de bandes actives ("2" à "8") : les paramètres des bandes suivantes sont ignorés
+    juce::StringArray bandCounts;
+    for (int n = BandCount::min; n <= BandCount::max; ++n)
+        bandCounts.add (juce::String (n));
 
+    params.push_back (std::make_unique<juce::AudioParameterChoice> ("BANDS", "Bands", bandCounts, 4 - BandCount::min));
+
+    for (int b = 1; b <= BandCount::max; ++b)
+        params.push_back (std::make_unique<juce::AudioParameterFloat> ("WIDTH" + juce::String (b), "Width Band " + juce::String (b), 0.0f, 2.0f, 1.0f));
+
+    // Fréquences de séparation, réparties en échelle logarithmique
+    auto frequencyRange = juce::NormalisableRange<float> (20.0f, 20000.0f);
+    frequencyRange.setSkewForCentre (632.0f);
+    const auto hz = juce::AudioParameterFloatAttributes().withLabel ("Hz");
+
+    const std::array<float, BandCount::maxCrossovers> defaultFrequencies { 200.0f, 1000.0f, 5000.0f, 8000.0f, 11000.0f, 14000.0f, 17000.0f };
+    for (size_t i = 0; i < defaultFrequencies.size(); ++i)
+        params.push_back (std::make_unique<juce::AudioParameterFloat> ("XOVER" + juce::String (i + 1), "Crossover " + juce::String (i + 1), frequencyRange, defaultFrequencies[i], hz));
+
+    // L'ordre des choix suit CrossoverSlope
+    params.push_back (std::make_unique<juce::AudioParameterChoice> ("SLOPE", "Crossover Slope", juce::StringArray { "12 dB/oct", "24 dB/oct", "48 dB/oct" }, 1));
+
+    // Phase linéaire : FIR par convolution partitionnée, avec une latence d'environ 100 ms
+    params.push_back (std::make_unique<juce::AudioParameterChoice> ("CROSSOVER_MODE", "Crossover Mode", juce::StringArray { "IIR", "Linear phase" }, 0));
+
+    // "Side only" ne sépare que le side (environ deux fois moins de filtres) ; sans
+    // mid par bande, les mesures par bande et la sécurité mono sont alors suspendues.
+    // Ignoré en phase linéaire.
+    params.push_back (std::make_unique<juce::AudioParameterChoice> ("SPLIT_MODE", "Band Split", juce::StringArray { "Mid and side", "Side only" }, 0));
+
+    // L'ordre des choix suit OversamplingFactors::Factor. En rendu hors ligne, le
+    // second paramètre peut imposer une qualité plus haute que celle du live.
+    params.push_back (std::make_unique<juce::AudioParameterChoice> ("OVERSAMPLING", "Oversampling", juce::StringArray { "Off", "2x", "4x" }, 0));
+    params.push_back (std::make_unique<juce::AudioParameterChoice> ("OVERSAMPLING_RENDER", "Render Oversampling", juce::StringArray { "Same as live", "Off", "2x", "4x" }, 0));
+
+    // Basses mono : le side est coupé sous MONO_BELOW, quelle que soit la largeur des bandes
+    auto monoBelowRange = juce::NormalisableRange<float> (20.0f, 500.0f);
+    monoBelowRange.setSkewForCentre (120.0f);
+    params.push_back (std::make_unique<juce::AudioParameterBool> ("MONO_BASS", "Mono Bass", false));
+    params.push_back (std::make_unique<juce::AudioParameterFloat> ("MONO_BELOW", "Mono Below", monoBelowRange, 120.0f, hz));
+
+    // Corrélation minimale de chaque bande ; à -1 la largeur n'est jamais plafonnée
+    params.push_back (std::make_unique<juce::AudioParameterFloat> ("MONO_SAFETY", "Mono Safety", juce::NormalisableRange<float> (-1.0f, 1.0f), -1.0f, juce::AudioParameterFloatAttributes().withLabel ("min. correlation")));
 
     return { params.begin(), params.end() };
 }
 
 void PluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    juce::dsp::ProcessSpec spec {};
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumOutputChannels();
+    baseSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlock;
+
+    numBands = getNumBandsParameter();
+
+    // Le FIR (noyaux, thread de calcul) n'existe qu'une fois la phase linéaire choisie
+    if (isLinearPhaseSelected() || linearPhaseCrossover.isPrepared())
+        prepareLinearPhase();
+
+    // L'hôte ne change de précision qu'entre deux prepareToPlay
+    if (isUsingDoublePrecision())
+        prepareChain (doubleChain);
+    else
+        prepareChain (floatChain);
 
-    multibandWidget.prepare (spec);
+    pendingLatency.store (getProcessingLatency());
+    setLatencySamples (pendingLatency.load());
 
+    // Relève ce que le thread audio laisse au thread message (voir applyPendingChanges).
+    // Hors ligne, le facteur et le mode ne changent qu'entre deux prepareToPlay.
+    if (! isNonRealtime())
+        pendingChangesPoller->addClient (*this);
+
+    stereoMeters.prepare (sampleRate);
+    monoSafety.prepare (sampleRate);
+    analysisEngine.prepare (sampleRate);
+    performanceMonitor.prepare (sampleRate);
+}
+
+template <typename SampleType>
+PluginProcessor::ProcessingChain<SampleType>& PluginProcessor::getChain() noexcept
+{
+    if constexpr (std::is_same_v<SampleType, double>)
+        return doubleChain;
+    else
+        return floatChain;
+}
+
+template <typename SampleType>
+void PluginProcessor::prepareChain (ProcessingChain<SampleType>& chain)
+{
     const int numChannels = getTotalNumOutputChannels();
 
-    const int circularBufferSize = scopeBufferSize * 2;
+    // Le traitement mid/side travaille toujours en stéréo. Les bandes sont
+    // dimensionnées pour le plus grand facteur de suréchantillonnage.
+    chain.workspace.prepare (juce::jmax (2, numChannels), preparedBlockSize * OversamplingFactors::maxFactor);
+    chain.oversampling.prepare (numChannels, preparedBlockSize);
+
+    chain.crossover.setNumBands (numBands);
+    chain.crossover.setCrossoverFrequencies (getCrossoverFrequencies());
+
+    prepareProcessing (chain, isLinearPhaseSelected(), getOversamplingFactor());
+}
 
-    circularBuffer.setSize (numChannels, circularBufferSize);
-    circularBuffer.clear();
+template <typename SampleType>
+void PluginProcessor::prepareProcessing (ProcessingChain<SampleType>& chain, bool linearPhase, OversamplingFactors::Factor factor)
+{
+    // N'alloue rien : appelable depuis processBlock quand le mode ou le facteur change.
+    // Le FIR à phase linéaire ne souffre pas de la déformation près de Nyquist :
+    // il tourne toujours au taux de base.
+    linearPhaseActive.store (linearPhase);
+    currentFactor = linearPhase ? OversamplingFactors::Factor::x1 : factor;
+    const int multiplier = OversamplingFactors::toMultiplier (currentFactor);
 
-    scopeBuffer.setSize (numChannels, scopeBufferSize);
-    scopeBuffer.clear();
+    juce::dsp::ProcessSpec spec {};
+    spec.sampleRate = baseSampleRate * multiplier;
+    spec.maximumBlockSize = (juce::uint32) (preparedBlockSize * multiplier);
+    spec.numChannels = (juce::uint32) getTotalNumOutputChannels();
 
-    circularFifo.setTotalSize (circularBufferSize); 
+    chain.crossover.prepare (spec);
+    chain.width.setMonoBass (monoBassParameter->load() > 0.5f, monoBelowParameter->load());
+    chain.width.prepare (spec.sampleRate, getWidths());
+    chain.oversampling.reset();
+
+    if (linearPhase)
+        linearPhaseCrossover.reset();
+}
+
+void PluginProcessor::prepareLinearPhase()
+{
+    linearPhaseCrossover.setNumBands (getNumBandsParameter());
+    linearPhaseCrossover.setCrossoverFrequencies (getCrossoverFrequencies());
+    linearPhaseCrossover.prepare (baseSampleRate, getTotalNumOutputChannels());
+}
+
+int PluginProcessor::getNumBandsParameter() const
+{
+    return BandCount::min + (int) numBandsParameter->load();
+}
+
+bool PluginProcessor::isLinearPhaseSelected() const
+{
+    return crossoverModeParameter->load() > 0.5f;
+}
+
+int PluginProcessor::getProcessingLatency() const
+{
+    if (linearPhaseActive.load())
+        return LinearPhaseCrossover::getLatencySamples();
+
+    // Seule la chaîne préparée connaît sa latence
+    if (isUsingDoublePrecision())
+        return doubleChain.oversampling.getLatencySamples (currentFactor);
+
+    return floatChain.oversampling.getLatencySamples (currentFactor);
+}
+
+OversamplingFactors::Factor PluginProcessor::getOversamplingFactor() const
+{
+    // "Same as live" (0) reprend le réglage live, sinon choix décalé d'un cran
+    const int renderChoice = (int) renderOversamplingParameter->load();
+    if (isNonRealtime() && renderChoice > 0)
+        return static_cast<OversamplingFactors::Factor> (renderChoice - 1);
+
+    return static_cast<OversamplingFactors::Factor> ((int) oversamplingParameter->load());
+}
+
+void PluginProcessor::applyPendingChanges()
+{
+    // Phase linéaire choisie pour la première fois pendant la lecture : le FIR est
+    // alloué ici, le thread audio reste sur l'IIR en attendant isPrepared
+    if (isLinearPhaseSelected() && ! linearPhaseCrossover.isPrepared() && preparedBlockSize > 0)
+        prepareLinearPhase();
+
+    // Ne prévient l'hôte que si la valeur change
+    setLatencySamples (pendingLatency.load());
 }
 //==============================================================================
 const juce::String PluginProcessor::getName() const
@@ -88,34 +251,37 @@ bool PluginProcessor::isMidiEffect() const
 
 double PluginProcessor::getTailLengthSeconds() const
 {
+    // Le FIR continue de sortir du signal pendant toute la longueur du noyau
+    if (linearPhaseActive.load())
+        return (LinearPhaseCrossover::getLatencySamples() + LinearPhaseCrossover::kernelLength / 2) / baseSampleRate;
+
     return 0.0;
 }
 
 int PluginProcessor::getNumPrograms()
 {
-    return 1; // NB: some hosts don't cope very well if you tell them there are 0 programs,
+    return juce::jmax (1, presetBank.getNumPresets()); // NB: some hosts don't cope very well if you tell them there are 0 programs,
         // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int PluginProcessor::getCurrentProgram()
 {
-    return 0;
+    return presetBank.getCurrentPreset();
 }
 
 void PluginProcessor::setCurrentProgram (int index)
 {
-    juce::ignoreUnused (index);
+    presetBank.loadPreset (index);
 }
 
 const juce::String PluginProcessor::getProgramName (int index)
 {
-    juce::ignoreUnused (index);
-    return {};
+    return presetBank.getPresetName (index);
 }
 
 void PluginProcessor::changeProgramName (int index, const juce::String& newName)
 {
-    juce::ignoreUnused (index, newName);
+    presetBank.setPresetName (index, newName);
 }
 
 
@@ -123,6 +289,7 @@ void PluginProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    pendingChangesPoller->removeClient (*this);
 }
 
 bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -151,109 +318,199 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     juce::MidiBuffer& midiMessages)
 {
     (void) midiMessages;
+    processBlockInPrecision (buffer);
+}
+
+void PluginProcessor::processBlock (juce::AudioBuffer<double>& buffer,
+    juce::MidiBuffer& midiMessages)
+{
+    (void) midiMessages;
+    processBlockInPrecision (buffer);
+}
+
+template <typename SampleType>
+void PluginProcessor::processBlockInPrecision (juce::AudioBuffer<SampleType>& buffer)
+{
     juce::ScopedNoDenormals noDenormals;
+    auto& chain = getChain<SampleType>();
 
-    const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
+    const PerformanceMonitor::ScopedBlock blockTimer (performanceMonitor, numSamples);
+    const int maxChunkSize = preparedBlockSize;
+
+    jassert (maxChunkSize > 0); // prepareToPlay doit avoir été appelé
+    if (maxChunkSize <= 0)
+        return;
+
+    // Le FIR est alloué sur le thread message à sa première sélection. Rien n'est
+    // posté d'ici : le PendingChangesPoller relève pendingLatency et le FIR à préparer.
+    const bool linearPhase = isLinearPhaseSelected() && linearPhaseCrossover.isPrepared();
+    const auto factor = linearPhase ? OversamplingFactors::Factor::x1 : getOversamplingFactor();
+    if (linearPhase != linearPhaseActive.load() || factor != currentFactor)
+    {
+        prepareProcessing (chain, linearPhase, factor);
+        pendingLatency.store (getProcessingLatency());
+    }
 
-    // Initialisation des buffers pour chaque bande
-    juce::AudioBuffer<float> low (numChannels, numSamples);
-    juce::AudioBuffer<float> midLow (numChannels, numSamples);
-    juce::AudioBuffer<float> midHigh (numChannels, numSamples);
-    juce::AudioBuffer<float> high (numChannels, numSamples);
+    // Changer le nombre de bandes ne réalloue rien : tout est dimensionné pour maxBands
+    numBands = getNumBandsParameter();
+    chain.crossover.setNumBands (numBands);
 
-    low.clear();
-    midLow.clear();
-    midHigh.clear();
-    high.clear();
+    chain.crossover.setSlope (static_cast<CrossoverSlope> ((int) slopeParameter->load()));
+    chain.width.setMonoBass (monoBassParameter->load() > 0.5f, monoBelowParameter->load());
+    monoSafety.setMinimumCorrelation (monoSafetyParameter->load());
 
-    // Traitement du signal en 4 bandes
-    multibandWidget.process (buffer, low, midLow, midHigh, high);
+    // Le mid passe par d'autres filtres selon le mode : on repart d'un état vide
+    if (const bool sideOnly = ! linearPhase && splitModeParameter->load() > 0.5f; sideOnly != sideOnlySplit)
+    {
+        sideOnlySplit = sideOnly;
+        chain.crossover.reset();
+        stereoMeters.reset();
+        monoSafety.reset();
+    }
 
-    // Récupération des paramètres width
-    float width1 = *apvts.getRawParameterValue ("WIDTH1");
-    float width2 = *apvts.getRawParameterValue ("WIDTH2");
-    float width3 = *apvts.getRawParameterValue ("WIDTH3");
-    float width4 = *apvts.getRawParameterValue ("WIDTH4");
+    // Seul le crossover utilisé suit les paramètres : en IIR, le thread des noyaux dort
+    if (linearPhase)
+    {
+        linearPhaseCrossover.setNumBands (numBands);
+        linearPhaseCrossover.setCrossoverFrequencies (getCrossoverFrequencies());
+    }
+    else
+    {
+        chain.crossover.setCrossoverFrequencies (getCrossoverFrequencies());
+    }
 
-    auto applyWidth = [&] (juce::AudioBuffer<float>& band, float width) {
-        if (band.getNumChannels() < 2)
-            return; // On ne peut pas faire de traitement mid/side sans 2 canaux
+    // Si l'hôte envoie un bloc plus grand que prévu, on le découpe plutôt que de réallouer
+    juce::dsp::AudioBlock<SampleType> block (buffer);
+    chain.width.clearSums();
+    for (int offset = 0; offset < numSamples; offset += maxChunkSize)
+    {
+        const int chunkSize = juce::jmin (maxChunkSize, numSamples - offset);
+        auto chunk = block.getSubBlock ((size_t) offset, (size_t) chunkSize);
+        chain.oversampling.process (currentFactor, chunk, [this] (const juce::dsp::AudioBlock<SampleType>& oversampled) {
+            processBands (oversampled);
+        });
+    }
 
-        auto* left = band.getWritePointer (0);
-        auto* right = band.getWritePointer (1);
-        int numSamplesBand = band.getNumSamples();
+    // Les sommes ont été accumulées pendant la passe de largeur (stéréo et mid
+    // séparé uniquement)
+    if (buffer.getNumChannels() >= 2 && ! sideOnlySplit)
+    {
+        stereoMeters.publish (chain.width.getSums(), numSamples);
+        monoSafety.update (chain.width.getSums(), numSamples);
+    }
 
-        for (int i = 0; i < numSamplesBand; ++i)
-        {
-            float mid = 0.5f * (left[i] + right[i]);
-            float side = 0.5f * (left[i] - right[i]);
-            side *= width;
-            left[i] = mid + side;
-            right[i] = mid - side;
-        }
-    };
+    // Envoi vers l'affichage, sans verrou (ignoré si aucun éditeur n'est ouvert)
+    const PerformanceMonitor::ScopedStage analysisTimer (performanceMonitor, PerformanceMonitor::Stage::analysis);
+    analysisEngine.push (buffer);
+}
 
-    applyWidth (low, width1);
-    applyWidth (midLow, width2);
-    applyWidth (midHigh, width3);
-    applyWidth (high, width4);
+std::array<float, BandCount::maxCrossovers> PluginProcessor::getCrossoverFrequencies() const
+{
+    // Seul passage des XOVER vers les crossovers. Bornées sous Nyquist du taux de
+    // base (au-delà, la tangente des SVF change de signe et le filtre diverge ; le
+    // suréchantillonnage n'a rien à séparer plus haut) et rendues croissantes :
+    // chaque XOVER est automatisable indépendamment des autres.
+    const auto highest = (float) (0.49 * baseSampleRate);
+    auto lowest = 0.0f;
+
+    std::array<float, BandCount::maxCrossovers> frequencies;
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        frequencies[i] = juce::jlimit (lowest, highest, crossoverParameters[i]->load());
+        lowest = frequencies[i];
+    }
 
-    // Remise à zéro du buffer principal avant addition des bandes
-    buffer.clear();
+    return frequencies;
+}
 
-    // Addition des bandes dans le buffer principal avec vérifications
-    for (int ch = 0; ch < numChannels; ++ch)
-    {
-        if (ch < low.getNumChannels())
-            buffer.addFrom (ch, 0, low, ch, 0, low.getNumSamples());
+std::array<float, BandCount::max> PluginProcessor::getWidths() const
+{
+    std::array<float, BandCount::max> widths;
+    for (size_t b = 0; b < widths.size(); ++b)
+        widths[b] = widthParameters[b]->load();
+
+    return widths;
+}
 
-        if (ch < midLow.getNumChannels())
-            buffer.addFrom (ch, 0, midLow, ch, 0, midLow.getNumSamples());
+template <typename SampleType>
+void PluginProcessor::processBands (const juce::dsp::AudioBlock<SampleType>& block)
+{
+    BandCount::dispatch (numBands, [this, &block] (auto n) { processBands<decltype (n)::value> (block); });
+}
 
-        if (ch < midHigh.getNumChannels())
-            buffer.addFrom (ch, 0, midHigh, ch, 0, midHigh.getNumSamples());
+template <size_t numBandsToUse, typename SampleType>
+void PluginProcessor::processBands (const juce::dsp::AudioBlock<SampleType>& block)
+{
+    auto& chain = getChain<SampleType>();
+    const int numChannels = (int) block.getNumChannels();
+    const int numSamples = (int) block.getNumSamples();
 
-        if (ch < high.getNumChannels())
-            buffer.addFrom (ch, 0, high, ch, 0, high.getNumSamples());
-    }
+    std::array<juce::dsp::AudioBlock<SampleType>, numBandsToUse> bands;
+    for (size_t b = 0; b < bands.size(); ++b)
+        bands[b] = chain.workspace.getBand ((int) b, numChannels, numSamples);
 
-    // Gestion du buffer circulaire pour scope
-    const int maxSamples = buffer.getNumSamples();
-    const int totalFifoSize = circularFifo.getTotalSize();
-    const int numSamplesToCopy = juce::jmin (totalFifoSize, maxSamples);
+    const bool linearPhase = linearPhaseActive.load (std::memory_order_relaxed);
 
+    if (numChannels < 2)
     {
-        std::scoped_lock lock (scopeBufferMutex);
-
-        if (circularFifo.getFreeSpace() >= numSamplesToCopy && numSamplesToCopy > 0)
+        // On ne peut pas faire de traitement mid/side sans 2 canaux
         {
-            int start1, size1, start2, size2;
-            circularFifo.prepareToWrite (numSamplesToCopy, start1, size1, start2, size2);
-
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                if (size1 > 0)
-                    circularBuffer.copyFrom (ch, start1, buffer, ch, 0, size1);
-                if (size2 > 0)
-                    circularBuffer.copyFrom (ch, start2, buffer, ch, size1, size2);
-            }
-            circularFifo.finishedWrite (size1 + size2);
+            const PerformanceMonitor::ScopedStage splitTimer (performanceMonitor, PerformanceMonitor::Stage::bandSplit);
+
+            if (linearPhase)
+                linearPhaseCrossover.process (block, bands.data(), (int) numBandsToUse);
+            else
+                chain.crossover.template process<numBandsToUse> (block, bands.data());
         }
 
-        int start1, size1, start2, size2;
-        circularFifo.prepareToRead (scopeBufferSize, start1, size1, start2, size2);
+        const PerformanceMonitor::ScopedStage widthTimer (performanceMonitor, PerformanceMonitor::Stage::width);
+        block.copyFrom (bands[0]);
+        for (size_t b = 1; b < bands.size(); ++b)
+            block.add (bands[b]);
+        return;
+    }
 
-        for (int ch = 0; ch < scopeBuffer.getNumChannels(); ++ch)
-        {
-            if (size1 > 0)
-                scopeBuffer.copyFrom (ch, 0, circularBuffer, ch, start1, size1);
-            if (size2 > 0)
-                scopeBuffer.copyFrom (ch, size1, circularBuffer, ch, start2, size2);
-        }
+    auto* mid = block.getChannelPointer (0);
+    auto* side = block.getChannelPointer (1);
+
+    // Séparation en numBandsToUse bandes, directement en mid/side : les filtres étant
+    // linéaires, c'est équivalent à séparer L et R puis encoder chaque bande, avec un
+    // seul encodage (sur place) au lieu d'un par bande
+    {
+        const PerformanceMonitor::ScopedStage splitTimer (performanceMonitor, PerformanceMonitor::Stage::bandSplit);
+
+        WidthKernel::encode (mid, side, numSamples);
 
-        circularFifo.finishedRead (size1 + size2);
+        if (linearPhase)
+            linearPhaseCrossover.process (block, bands.data(), (int) numBandsToUse);
+        else if (sideOnlySplit)
+            chain.crossover.template processSideOnly<numBandsToUse> (block, bands.data());
+        else
+            chain.crossover.template process<numBandsToUse> (block, bands.data());
     }
+
+    // Largeur de chaque bande (lissée, plafonnée par la sécurité mono), addition et
+    // décodage en L/R dans le buffer principal, en une passe
+    const PerformanceMonitor::ScopedStage widthTimer (performanceMonitor, PerformanceMonitor::Stage::width);
+
+    using Width = WidthStage<SampleType>;
+    typename Width::template BandPointers<numBandsToUse> midBands, sideBands;
+    for (size_t b = 0; b < bands.size(); ++b)
+    {
+        midBands[b] = bands[b].getChannelPointer (0);
+        sideBands[b] = bands[b].getChannelPointer (1);
+    }
+
+    auto widths = getWidths();
+    monoSafety.limit (widths);
+    chain.width.setTargetWidths (widths);
+
+    // En mode side seul, le mid (déjà passé dans le passe-tout) est lu sur place
+    if (sideOnlySplit)
+        chain.width.process (typename Width::template BandPointers<1> { mid }, sideBands, mid, side, numSamples);
+    else
+        chain.width.process (midBands, sideBands, mid, side, numSamples);
 }
 
 //==============================================================================
@@ -270,17 +527,14 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 //==============================================================================
 void PluginProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-    juce::ignoreUnused (destData);
+    // Tous les paramètres de l'apvts, fréquences de séparation comprises
+    pluginState.write (destData);
 }
 
 void PluginProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-    juce::ignoreUnused (data, sizeInBytes);
+    // Des données illisibles ou d'une version future laissent l'état actuel intact
+    pluginState.restore (data, sizeInBytes);
 }
 
 //==============================================================================
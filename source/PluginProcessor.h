@@ -1,13 +1,25 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
-#include "components/MultibandWidget.h"
+#include "dsp/AnalysisEngine.h"
+#include "dsp/BandWorkspace.h"
+#include "dsp/CrossoverEngine.h"
+#include "dsp/LinearPhaseCrossover.h"
+#include "dsp/MonoSafety.h"
+#include "dsp/OversamplingStage.h"
+#include "dsp/PendingChangesPoller.h"
+#include "dsp/PerformanceMonitor.h"
+#include "dsp/StereoMeters.h"
+#include "dsp/WidthStage.h"
+#include "state/PluginState.h"
+#include "state/PresetBank.h"
 
 #if (MSVC)
     #include "ipps.h"
 #endif
 
-class PluginProcessor : public juce::AudioProcessor
+class PluginProcessor : public juce::AudioProcessor,
+                        private PendingChangesPoller::Client
 {
 public:
     PluginProcessor();
@@ -18,7 +30,11 @@ public:
 
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
+    // Tout le traitement existe en float et en double : l'hôte choisit la
+    // précision avant prepareToPlay (setProcessingPrecision)
+    bool supportsDoublePrecisionProcessing() const override { return true; }
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -39,22 +55,114 @@ public:
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
 
-    std::mutex& getScopeBufferMutex() { return scopeBufferMutex; }
-    const juce::AudioBuffer<float>& getScopeBuffer() const { return scopeBuffer;}
+    // Analyse de la sortie (spectre et scope) pour l'éditeur.
+    // Tant que l'éditeur ne l'active pas, le thread audio n'envoie rien.
+    AnalysisEngine& getAnalysisEngine() noexcept { return analysisEngine; }
 
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
+    // Corrélation, balance et rapport side/mid de chaque bande, mis à jour à chaque bloc
+    const StereoMeters& getStereoMeters() const noexcept { return stereoMeters; }
 
-private:
+    // Charge du thread audio (fraction du budget de chaque bloc), par étape et en histogramme
+    const PerformanceMonitor& getPerformanceMonitor() const noexcept { return performanceMonitor; }
+    void resetPerformanceStatistics() noexcept { performanceMonitor.resetStatistics(); }
 
-    MultibandWidget multibandWidget;
+    // Presets en mémoire, exposés aussi à l'hôte comme programmes
+    PresetBank& getPresetBank() noexcept { return presetBank; }
 
-    juce::AudioBuffer<float> scopeBuffer;
-    juce::AudioBuffer<float> circularBuffer;
-    juce::AbstractFifo circularFifo { 2048 };
-    const int scopeBufferSize = 512;
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    // Thread message : applique ce que le thread audio a laissé en attente (latence,
+    // allocation du FIR). Appelée par le PendingChangesPoller partagé, ou directement
+    // sans boucle de messages (tests). Le thread audio ne poste rien : un message peut allouer.
+    void applyPendingChanges() override;
 
-    std::mutex scopeBufferMutex;
+private:
+    // Format binaire de getStateInformation, partagé avec les presets
+    PluginState pluginState { apvts };
+    PresetBank presetBank { pluginState };
+
+    // Étapes qui travaillent dans la précision de l'hôte. Les deux chaînes
+    // existent, seule celle de la précision en cours est préparée (ses buffers
+    // de bandes sont alloués dans prepareToPlay, aucune allocation dans processBlock).
+    template <typename SampleType>
+    struct ProcessingChain
+    {
+        CrossoverEngine<SampleType> crossover;
+        BandWorkspace<SampleType> workspace;
+        WidthStage<SampleType> width;
+
+        // Suréchantillonnage : le facteur actif peut changer d'un bloc à l'autre
+        // (paramètre ou rendu hors ligne) ; la latence est alors remontée à l'hôte
+        // depuis le thread message.
+        OversamplingStage<SampleType> oversampling;
+    };
+
+    ProcessingChain<float> floatChain;
+    ProcessingChain<double> doubleChain;
+
+    template <typename SampleType>
+    ProcessingChain<SampleType>& getChain() noexcept;
+
+    StereoMeters stereoMeters;
+    MonoSafety monoSafety;
+    std::array<std::atomic<float>*, BandCount::max> widthParameters {};
+    std::array<std::atomic<float>*, BandCount::maxCrossovers> crossoverParameters {};
+    std::atomic<float>* numBandsParameter = nullptr;
+    std::atomic<float>* slopeParameter = nullptr;
+    std::atomic<float>* crossoverModeParameter = nullptr;
+    std::atomic<float>* oversamplingParameter = nullptr;
+    std::atomic<float>* renderOversamplingParameter = nullptr;
+    std::atomic<float>* monoBassParameter = nullptr;
+    std::atomic<float>* monoBelowParameter = nullptr;
+    std::atomic<float>* monoSafetyParameter = nullptr;
+    std::atomic<float>* splitModeParameter = nullptr;
+
+    // Mode "side seul" du paramètre SPLIT_MODE, effectif hors phase linéaire
+    bool sideOnlySplit = false;
+
+    OversamplingFactors::Factor currentFactor = OversamplingFactors::Factor::x1;
+
+    // Alternative au CrossoverEngine pour le mastering (paramètre CROSSOVER_MODE)
+    LinearPhaseCrossover linearPhaseCrossover;
+    std::atomic<bool> linearPhaseActive { false };
+    std::atomic<int> pendingLatency { 0 };
+    double baseSampleRate = 44100.0;
+    int preparedBlockSize = 0;
+
+    // Inscrit de prepareToPlay à releaseResources, sauf en rendu hors ligne
+    juce::SharedResourcePointer<PendingChangesPoller> pendingChangesPoller;
+
+    OversamplingFactors::Factor getOversamplingFactor() const;
+    bool isLinearPhaseSelected() const;
+    int getProcessingLatency() const;
+    void prepareLinearPhase();
+
+    template <typename SampleType>
+    void prepareChain (ProcessingChain<SampleType>& chain);
+
+    template <typename SampleType>
+    void prepareProcessing (ProcessingChain<SampleType>& chain, bool linearPhase, OversamplingFactors::Factor factor);
+
+    // Nombre de bandes lu une fois par bloc : processBands aiguille vers la
+    // version compilée pour ce nombre (boucles sur les bandes déroulées)
+    int numBands = 4;
+    int getNumBandsParameter() const;
+
+    std::array<float, BandCount::maxCrossovers> getCrossoverFrequencies() const;
+    std::array<float, BandCount::max> getWidths() const;
+
+    template <typename SampleType>
+    void processBlockInPrecision (juce::AudioBuffer<SampleType>& buffer);
+
+    template <typename SampleType>
+    void processBands (const juce::dsp::AudioBlock<SampleType>& block);
+
+    template <size_t numBandsToUse, typename SampleType>
+    void processBands (const juce::dsp::AudioBlock<SampleType>& block);
+
+    AnalysisEngine analysisEngine;
+    PerformanceMonitor performanceMonitor;
 
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
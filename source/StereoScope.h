@@ -1,22 +1,190 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "dsp/AnalysisEngine.h"
 
-class StereoScope : public juce::Component, private juce::Timer
+class StereoScope : public juce::Component
 {
 public:
-    StereoScope()
+    // Traînée de points (trail) ou image rémanente façon phosphore (phosphor)
+    enum class Mode { trail, phosphor };
+
+    // midSide : x = L-R, y = L+R. goniometer : axes L et R tournés de 45°,
+    // un signal mono est vertical et un signal sur L seul part en haut à gauche.
+    enum class Axes { midSide, goniometer };
+
+    void setScopeWindow(const ScopeWindow* window)
+    {
+        scopeWindow = window;
+    }
+
+    void setMode(Mode newMode)
+    {
+        mode = newMode;
+        clearPhosphor();
+        repaint();
+    }
+
+    void setAxes(Axes newAxes)
     {
-        setFramesPerSecond(60);
-        startTimerHz(frameRate);
+        axes = newAxes;
+        clearPhosphor();
+        staticLayer = {};
+        repaint();
     }
 
-    void setAudioBuffer(const juce::AudioBuffer<float>* buffer)
+    // Vrai tant que l'image rémanente n'est pas éteinte : en silence, l'éditeur
+    // continue d'appeler updateScope pour qu'elle finisse de décroître
+    bool isPhosphorLit() const
     {
-        audioBuffer = buffer;
+        return mode == Mode::phosphor && phosphorPeak >= 1.0f / 255.0f;
+    }
+
+    // À chaque trame de l'éditeur (FrameScheduler) : trace les échantillons
+    // arrivés depuis la trame précédente
+    void updateScope()
+    {
+        if (!scopeWindow || scopeWindow->samples.getNumChannels() < 2)
+            return;
+
+        const auto& buffer = scopeWindow->samples;
+        auto* left = buffer.getReadPointer(0);
+        auto* right = buffer.getReadPointer(1);
+
+        // Seuls les échantillons arrivés depuis la dernière trame sont tracés
+        const auto available = scopeWindow->endSample - lastSample;
+        const int numNew = (int)juce::jlimit((juce::int64)0, (juce::int64)buffer.getNumSamples(), available < 0 ? scopeWindow->endSample : available);
+        lastSample = scopeWindow->endSample;
+
+        const int first = buffer.getNumSamples() - numNew;
+
+        auto area = getLocalBounds().toFloat().reduced(10.0f);
+        auto centre = area.getCentre();
+        float radius = juce::jmin(area.getWidth(), area.getHeight()) * 0.5f;
+
+        // Seule la zone de tracé est redessinée, le calque statique est recomposé dessous
+        if (mode == Mode::phosphor)
+        {
+            updatePhosphor(left + first, right + first, numNew, centre, radius);
+            repaint(getPlotBounds(centre, radius).getSmallestIntegerContainer());
+        }
+        else if (numNew > 0)
+        {
+            // Toutes les trames vieillissent (alpha) : l'union de leurs zones,
+            // plus celle de la trame écrasée pour l'effacer
+            auto dirty = updateTrail(left + first, right + first, numNew, centre, radius);
+            for (int age = 0; age < numTrailFrames; ++age)
+                dirty = dirty.getUnion(trailBounds[(size_t)((newestFrame - age + maxTrailLength) % maxTrailLength)]);
+
+            repaint(dirty.expanded(1.0f).getSmallestIntegerContainer());
+        }
+    }
+
+    void resized() override
+    {
+        // Seul endroit où le buffer de rémanence est (ré)alloué
+        phosphorWidth = juce::jmax(1, getWidth());
+        phosphorHeight = juce::jmax(1, getHeight());
+        phosphorIntensity.assign((size_t)(phosphorWidth * phosphorHeight), 0.0f);
+        phosphorImage = juce::Image(juce::Image::ARGB, phosphorWidth, phosphorHeight, true);
+        phosphorPeak = 0.0f;
+        staticLayer = {};
+    }
+
+    void mouseDown(const juce::MouseEvent& e) override
+    {
+        if (!e.mods.isPopupMenu())
+            return;
+
+        juce::PopupMenu menu;
+        menu.addItem("Trail", true, mode == Mode::trail, [this] { setMode(Mode::trail); });
+        menu.addItem("Phosphor", true, mode == Mode::phosphor, [this] { setMode(Mode::phosphor); });
+        menu.addSeparator();
+        menu.addItem("L-R / L+R", true, axes == Axes::midSide, [this] { setAxes(Axes::midSide); });
+        menu.addItem("Goniometer", true, axes == Axes::goniometer, [this] { setAxes(Axes::goniometer); });
+        menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
     }
 
     void paint(juce::Graphics& g) override
     {
+        // Axes et étiquettes ne changent qu'au redimensionnement ou avec les axes :
+        // rendus une fois dans une image à la résolution de l'écran
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (!staticLayer.isValid() || scale != staticLayerScale)
+            renderStaticLayer(scale);
+
+        g.drawImage(staticLayer, getLocalBounds().toFloat());
+
+        if (mode == Mode::phosphor)
+            g.drawImageAt(phosphorImage, 0, 0);
+
+        // Tracé dynamique : un seul chemin par niveau d'alpha (une trame de la traînée)
+        for (int age = 0; mode == Mode::trail && age < numTrailFrames; ++age)
+        {
+            const int frame = (newestFrame - age + maxTrailLength) % maxTrailLength;
+            const int numPoints = trailSizes[(size_t)frame];
+            if (numPoints == 0)
+                continue;
+
+            const float* xs = trailX.data() + frame * maxPointsPerFrame;
+            const float* ys = trailY.data() + frame * maxPointsPerFrame;
+
+            framePath.clear(); // garde sa mémoire d'une trame à l'autre
+            for (int i = 0; i < numPoints; ++i)
+                framePath.addRectangle(xs[i] - 1.0f, ys[i] - 1.0f, 2.0f, 2.0f);
+
+            float alpha = 1.0f - (float)age / (float)numTrailFrames;
+            g.setColour(juce::Colours::cyan.withAlpha(alpha * 0.6f));
+            g.fillPath(framePath);
+        }
+    }
+
+private:
+    static constexpr int maxTrailLength = 20;
+    static constexpr int maxPointsPerFrame = 512;
+
+    // Rémanence : atténuation par trame et énergie déposée par échantillon
+    static constexpr float phosphorDecay = 0.85f;
+    static constexpr float phosphorHit = 0.15f;
+
+    const ScopeWindow* scopeWindow = nullptr;
+    juce::int64 lastSample = 0;
+
+    Mode mode = Mode::trail;
+    Axes axes = Axes::midSide;
+
+    // Axes et étiquettes, à l'échelle physique staticLayerScale
+    juce::Image staticLayer;
+    float staticLayerScale = 0.0f;
+
+    // Traînée en anneau de taille fixe, coordonnées séparées (x, y) et
+    // allouées une fois pour toutes : maxTrailLength trames de maxPointsPerFrame points
+    std::vector<float> trailX = std::vector<float>(maxTrailLength * maxPointsPerFrame);
+    std::vector<float> trailY = std::vector<float>(maxTrailLength * maxPointsPerFrame);
+    std::array<int, maxTrailLength> trailSizes {};
+    std::array<juce::Rectangle<float>, maxTrailLength> trailBounds {};
+    int newestFrame = 0;
+    int numTrailFrames = 0;
+
+    juce::Path framePath;
+
+    // Intensité par pixel (float, pour l'atténuation vectorisée) et image affichée
+    std::vector<float> phosphorIntensity;
+    juce::Image phosphorImage;
+    int phosphorWidth = 0;
+    int phosphorHeight = 0;
+    float phosphorPeak = 0.0f;
+
+    void renderStaticLayer(float scale)
+    {
+        staticLayerScale = scale;
+        staticLayer = juce::Image(juce::Image::ARGB,
+                                  juce::jmax(1, juce::roundToInt((float)getWidth() * scale)),
+                                  juce::jmax(1, juce::roundToInt((float)getHeight() * scale)),
+                                  true);
+
+        juce::Graphics g(staticLayer);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
         auto area = getLocalBounds().toFloat().reduced(10);
 
         // Définir la zone de l'arc
@@ -39,68 +207,125 @@ public:
 
 
         g.drawLine(area.getCentreX(), area.getY(), area.getCentreX(), area.getBottom());
-        g.drawLine(area.getX(), area.getCentreY(), area.getRight(), area.getCentreY());
-        // Tracé dynamique
-        for (size_t i = 0; i < trailFrames.size(); ++i)
+        if (axes == Axes::midSide)
         {
-            float alpha = 1.0f - (float)i / (float)trailFrames.size();
-            g.setColour(juce::Colours::cyan.withAlpha(alpha * 0.6f));
-
-            for (auto& pt : trailFrames[i])
-                g.fillEllipse(pt.x - 1.5f, pt.y - 1.5f, 3.0f, 3.0f);
+            g.drawLine(area.getX(), area.getCentreY(), area.getRight(), area.getCentreY());
+        }
+        else
+        {
+            g.drawLine(area.getX(), area.getY(), area.getRight(), area.getBottom());
+            g.drawLine(area.getRight(), area.getY(), area.getX(), area.getBottom());
         }
 
         // L et R
         g.setFont(14.0f);
         g.setColour(juce::Colours::white.withAlpha(0.8f));
-        g.drawText("L", static_cast<int>(area.getX()), static_cast<int>(area.getBottom() - 20), 20, 20, juce::Justification::centredLeft);
-        g.drawText("R", static_cast<int>(area.getRight() - 20), static_cast<int>(area.getBottom() - 20), 20, 20, juce::Justification::centredRight);
+        const float labelY = axes == Axes::goniometer ? area.getY() : area.getBottom() - 20;
+        g.drawText("L", static_cast<int>(area.getX()), static_cast<int>(labelY), 20, 20, juce::Justification::centredLeft);
+        g.drawText("R", static_cast<int>(area.getRight() - 20), static_cast<int>(labelY), 20, 20, juce::Justification::centredRight);
     }
 
-private:
-    const juce::AudioBuffer<float>* audioBuffer = nullptr;
-    std::vector<std::vector<juce::Point<float>>> trailFrames;
-    const int maxTrailLength = 20;
-    int frameRate = 60;
+    // Carré où toScreen place les points, plus la demi-taille d'un point
+    static juce::Rectangle<float> getPlotBounds(juce::Point<float> centre, float radius)
+    {
+        return juce::Rectangle<float>(radius * 2.0f, radius * 2.0f).withCentre(centre).expanded(1.0f);
+    }
 
-    void setFramesPerSecond(int fps) { frameRate = fps; }
+    void clearPhosphor()
+    {
+        std::fill(phosphorIntensity.begin(), phosphorIntensity.end(), 0.0f);
+        if (phosphorImage.isValid())
+            phosphorImage.clear(phosphorImage.getBounds());
+        phosphorPeak = 0.0f;
+        numTrailFrames = 0;
+    }
 
-    void timerCallback() override
+    juce::Point<float> toScreen(float l, float r, juce::Point<float> centre, float radius) const
     {
-        if (!audioBuffer || audioBuffer->getNumChannels() < 2)
-            return;
+        float x, y;
 
-        auto* left = audioBuffer->getReadPointer(0);
-        auto* right = audioBuffer->getReadPointer(1);
-        int numSamples = audioBuffer->getNumSamples();
+        if (axes == Axes::midSide)
+        {
+            x = juce::jlimit(-1.0f, 1.0f, (l - r));   // balance stéréo (L-R)
+            y = juce::jlimit(-1.0f, 1.0f, (l + r));   // amplitude (L+R)
+        }
+        else
+        {
+            constexpr float scale = 0.70710678f;
+            x = juce::jlimit(-1.0f, 1.0f, (r - l) * scale);
+            y = juce::jlimit(-1.0f, 1.0f, (l + r) * scale);
+        }
 
-        auto area = getLocalBounds().toFloat().reduced(10.0f);
-        float centerX = area.getCentreX();
-        float centerY = area.getCentreY();
-        float radius = juce::jmin(area.getWidth(), area.getHeight()) * 0.5f;
+        return { centre.x + x * radius, centre.y - y * radius };
+    }
 
-        std::vector<juce::Point<float>> framePoints;
+    // Renvoie la zone de la trame écrasée (vide s'il n'y en avait pas)
+    juce::Rectangle<float> updateTrail(const float* left, const float* right, int numSamples, juce::Point<float> centre, float radius)
+    {
+        // La trame la plus ancienne est écrasée
+        newestFrame = (newestFrame + 1) % maxTrailLength;
+        const auto overwritten = numTrailFrames == maxTrailLength ? trailBounds[(size_t)newestFrame] : juce::Rectangle<float>();
+        numTrailFrames = juce::jmin(numTrailFrames + 1, maxTrailLength);
+
+        float* xs = trailX.data() + newestFrame * maxPointsPerFrame;
+        float* ys = trailY.data() + newestFrame * maxPointsPerFrame;
+        int numPoints = 0;
+
+        int step = juce::jmax(1, (numSamples + maxPointsPerFrame - 1) / maxPointsPerFrame); // pour lisser sans perdre en densité
 
-        int step = juce::jmax(1, numSamples / 512); // pour lisser sans perdre en densité
+        float minX = centre.x, maxX = centre.x, minY = centre.y, maxY = centre.y;
 
         for (int i = 0; i < numSamples; i += step)
         {
-            float l = left[i];
-            float r = right[i];
+            const auto point = toScreen(left[i], right[i], centre, radius);
+            xs[numPoints] = point.x;
+            ys[numPoints] = point.y;
+            ++numPoints;
+
+            minX = juce::jmin(minX, point.x);
+            maxX = juce::jmax(maxX, point.x);
+            minY = juce::jmin(minY, point.y);
+            maxY = juce::jmax(maxY, point.y);
+        }
 
-            float x = juce::jlimit(-1.0f, 1.0f, (l - r));   // balance stéréo (L-R)
-            float y = juce::jlimit(-1.0f, 1.0f, (l + r));   // amplitude (L+R)
+        trailSizes[(size_t)newestFrame] = numPoints;
+        trailBounds[(size_t)newestFrame] = juce::Rectangle<float>::leftTopRightBottom(minX, minY, maxX, maxY).expanded(1.0f);
+        return overwritten;
+    }
+
+    // Coût fixe par trame (une passe sur l'image) plus un accès par échantillon,
+    // sans décimation : la densité ne dépend ni de la taille de bloc ni de la fréquence
+    void updatePhosphor(const float* left, const float* right, int numSamples, juce::Point<float> centre, float radius)
+    {
+        if (phosphorIntensity.empty())
+            return;
+
+        juce::FloatVectorOperations::multiply(phosphorIntensity.data(), phosphorDecay, (int)phosphorIntensity.size());
 
-            float px = centerX + x * radius;
-            float py = centerY - y * radius;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto point = toScreen(left[i], right[i], centre, radius);
+            const int px = (int)point.x;
+            const int py = (int)point.y;
 
-            framePoints.emplace_back(px, py);
+            if (px >= 0 && px < phosphorWidth && py >= 0 && py < phosphorHeight)
+                phosphorIntensity[(size_t)(py * phosphorWidth + px)] += phosphorHit;
         }
 
-        trailFrames.insert(trailFrames.begin(), framePoints);
-        if (trailFrames.size() > maxTrailLength)
-            trailFrames.pop_back();
+        phosphorPeak = juce::FloatVectorOperations::findMaximum(phosphorIntensity.data(), (int)phosphorIntensity.size());
 
-        repaint();
+        juce::Image::BitmapData pixels(phosphorImage, juce::Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < phosphorHeight; ++y)
+        {
+            const float* intensity = phosphorIntensity.data() + y * phosphorWidth;
+
+            for (int x = 0; x < phosphorWidth; ++x)
+            {
+                // Cyan prémultiplié
+                const auto alpha = (juce::uint8)(juce::jmin(intensity[x], 1.0f) * 255.0f);
+                reinterpret_cast<juce::PixelARGB*>(pixels.getPixelPointer(x, y))->setARGB(alpha, 0, alpha, alpha);
+            }
+        }
     }
-};
\ No newline at end of file
+};
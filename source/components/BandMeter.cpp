@@ -0,0 +1,44 @@
+#include "BandMeter.h"
+
+void BandMeter::setReading (const StereoMeters::Reading& newReading)
+{
+    // Évite un repaint quand rien n'a bougé à l'échelle de l'affichage
+    constexpr float tolerance = 0.005f;
+    if (std::abs (newReading.correlation - reading.correlation) < tolerance
+        && std::abs (newReading.balance - reading.balance) < tolerance
+        && std::abs (newReading.sideToMid - reading.sideToMid) < tolerance)
+        return;
+
+    reading = newReading;
+    repaint();
+}
+
+void BandMeter::paint (juce::Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+    const auto rowHeight = area.getHeight() / 3.0f;
+
+    // Corrélation : rouge quand elle passe en négatif (problème de compatibilité mono)
+    const auto correlationColour = reading.correlation < 0.0f ? juce::Colours::red : juce::Colours::deepskyblue;
+    drawCentredBar (g, area.removeFromTop (rowHeight).reduced (2.0f), reading.correlation, correlationColour);
+    drawCentredBar (g, area.removeFromTop (rowHeight).reduced (2.0f), reading.balance, juce::Colours::white.withAlpha (0.7f));
+
+    g.setFont (11.0f);
+    g.setColour (juce::Colours::white.withAlpha (0.8f));
+    g.drawText ("S/M " + juce::String (reading.sideToMid, 2), area, juce::Justification::centred);
+}
+
+void BandMeter::drawCentredBar (juce::Graphics& g, juce::Rectangle<float> area, float value, juce::Colour colour)
+{
+    g.setColour (juce::Colours::white.withAlpha (0.1f));
+    g.fillRect (area);
+
+    const auto centre = area.getCentreX();
+    const auto end = centre + juce::jlimit (-1.0f, 1.0f, value) * area.getWidth() * 0.5f;
+
+    g.setColour (colour);
+    g.fillRect (juce::Rectangle<float>::leftTopRightBottom (juce::jmin (centre, end), area.getY(), juce::jmax (centre, end), area.getBottom()));
+
+    g.setColour (juce::Colours::white.withAlpha (0.4f));
+    g.drawVerticalLine ((int) centre, area.getY(), area.getBottom());
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../dsp/StereoMeters.h"
+
+// Affiche les mesures stéréo d'une bande sous son slider de largeur :
+// corrélation et balance en barres centrées, rapport side/mid en texte.
+class BandMeter : public juce::Component
+{
+public:
+    void setReading (const StereoMeters::Reading& newReading);
+
+    void paint (juce::Graphics& g) override;
+
+private:
+    StereoMeters::Reading reading;
+
+    void drawCentredBar (juce::Graphics& g, juce::Rectangle<float> area, float value, juce::Colour colour);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandMeter)
+};
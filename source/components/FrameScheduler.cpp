@@ -0,0 +1,113 @@
+#include "FrameScheduler.h"
+#include <algorithm>
+
+FrameScheduler::FrameScheduler()
+{
+    // Tant qu'aucune synchronisation verticale n'arrive, le timer cadence les trames
+    startTimerHz (maxFramesPerSecond);
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    // Les éditeurs se désinscrivent avant de relâcher leur SharedResourcePointer
+    jassert (registrations.empty());
+    vblankAttachment.reset();
+    stopTimer();
+}
+
+void FrameScheduler::addClient (juce::Component& component, Client& client)
+{
+    registrations.push_back ({ &component, &client });
+    updateVBlankSource();
+}
+
+void FrameScheduler::removeClient (Client& client)
+{
+    registrations.erase (std::remove_if (registrations.begin(), registrations.end(), [&client] (const Registration& registration) {
+        return registration.client == &client;
+    }),
+        registrations.end());
+
+    updateVBlankSource();
+}
+
+bool FrameScheduler::isOnScreen (const juce::Component& component)
+{
+    // Caché, sans fenêtre ou minimisé
+    if (! component.isShowing())
+        return false;
+
+    // Fenêtre entièrement recouverte (occlusion signalée par le système)
+    if (auto* peer = component.getPeer())
+        return peer->isShowing();
+
+    return false;
+}
+
+void FrameScheduler::updateVBlankSource()
+{
+    juce::Component* source = nullptr;
+    for (auto& registration : registrations)
+    {
+        if (registration.component != nullptr && isOnScreen (*registration.component.getComponent()))
+        {
+            source = registration.component.getComponent();
+            break;
+        }
+    }
+
+    if (source == vblankSource.getComponent() && (source != nullptr) == (vblankAttachment != nullptr))
+        return;
+
+    vblankAttachment.reset();
+    vblankSource = source;
+
+    if (source != nullptr)
+        vblankAttachment = std::make_unique<juce::VBlankAttachment> (source, [this] { onVBlank(); });
+}
+
+void FrameScheduler::onVBlank()
+{
+    lastVBlankTime = juce::Time::getMillisecondCounterHiRes();
+
+    // La synchronisation verticale cadence les trames : le timer ne sert plus qu'à la surveiller
+    if (getTimerInterval() != watchdogIntervalMs)
+        startTimer (watchdogIntervalMs);
+
+    tick (lastVBlankTime);
+}
+
+void FrameScheduler::timerCallback()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    if (now - lastVBlankTime < vblankTimeoutMs)
+        return;
+
+    // Plus de synchronisation verticale : la source a quitté l'écran ou n'en
+    // fournit pas. On en cherche une autre et le timer cadence en attendant.
+    updateVBlankSource();
+
+    if (getTimerInterval() == watchdogIntervalMs)
+        startTimerHz (maxFramesPerSecond);
+
+    tick (now);
+}
+
+void FrameScheduler::tick (double now)
+{
+    // Au-dessus de 60 Hz, certaines synchronisations sont sautées. La marge évite
+    // d'en sauter une sur deux à 60 Hz à cause de la gigue.
+    constexpr double frameIntervalMs = 1000.0 / maxFramesPerSecond;
+    if (now - lastFrameTime < frameIntervalMs - 2.0)
+        return;
+
+    lastFrameTime = now;
+
+    // Par index : un client peut se désinscrire pendant la boucle
+    for (size_t i = 0; i < registrations.size(); ++i)
+    {
+        const auto registration = registrations[i];
+        if (registration.component != nullptr && isOnScreen (*registration.component.getComponent()))
+            registration.client->frameTick();
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+
+// Horloge d'affichage commune à toutes les instances du plugin chargées dans
+// le processus. Au lieu d'un Timer par composant et par éditeur, chaque
+// éditeur s'inscrit une fois ; un seul tick, cadencé par la synchronisation
+// verticale de l'écran (VBlankAttachment sur l'un des éditeurs visibles), les
+// sert tous, au plus maxFramesPerSecond fois par seconde.
+//
+// Un éditeur caché, minimisé ou masqué par une autre fenêtre n'est pas servi.
+// Sans synchronisation verticale (aucun éditeur à l'écran, plateforme qui n'en
+// fournit pas), un Timer prend le relais.
+//
+// À partager via juce::SharedResourcePointer<FrameScheduler> : créé avec le
+// premier éditeur ouvert, détruit avec le dernier. Thread message uniquement.
+class FrameScheduler : private juce::Timer
+{
+public:
+    static constexpr int maxFramesPerSecond = 60;
+
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Une trame : récupérer les données d'analyse et redessiner ce qui a changé
+        virtual void frameTick() = 0;
+    };
+
+    FrameScheduler();
+    ~FrameScheduler() override;
+
+    // component est celui dont la visibilité décide si client est servi
+    void addClient (juce::Component& component, Client& client);
+    void removeClient (Client& client);
+
+    static bool isOnScreen (const juce::Component& component);
+
+private:
+    // Au-delà, la synchronisation verticale est considérée comme arrêtée
+    static constexpr double vblankTimeoutMs = 100.0;
+    static constexpr int watchdogIntervalMs = 250;
+
+    struct Registration
+    {
+        juce::Component::SafePointer<juce::Component> component;
+        Client* client = nullptr;
+    };
+
+    std::vector<Registration> registrations;
+
+    std::unique_ptr<juce::VBlankAttachment> vblankAttachment;
+    juce::Component::SafePointer<juce::Component> vblankSource;
+    double lastVBlankTime = 0.0;
+    double lastFrameTime = 0.0;
+
+    void onVBlank();
+    void timerCallback() override;
+    void tick (double now);
+    void updateVBlankSource();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrameScheduler)
+};
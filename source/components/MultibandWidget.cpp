@@ -3,158 +3,167 @@
 
 MultibandWidget::MultibandWidget()
 {
-    startTimerHz (60); // pour update FFT et repaint
-
     setInterceptsMouseClicks (true, true);
-    setBufferedToImage (true);
     setPaintingIsUnclipped (true);
 }
 
-void MultibandWidget::prepare (const juce::dsp::ProcessSpec& spec)
+void MultibandWidget::attachToParameters (const std::array<juce::RangedAudioParameter*, maxCrossovers>& parameters)
 {
-    sampleRate = static_cast<float> (spec.sampleRate);
-
-    for (int ch = 0; ch < 2; ++ch)
+    for (size_t i = 0; i < frequencyAttachments.size(); ++i)
     {
-        lowPass1[ch].reset();
-        highPass1[ch].reset();
-        lowPass2[ch].reset();
-        highPass2[ch].reset();
-        lowPass3[ch].reset();
-        highPass3[ch].reset();
-
-        lowPass1[ch].prepare (spec);
-        highPass1[ch].prepare (spec);
-        lowPass2[ch].prepare (spec);
-        highPass2[ch].prepare (spec);
-        lowPass3[ch].prepare (spec);
-        highPass3[ch].prepare (spec);
+        jassert (parameters[i] != nullptr);
+        frequencyAttachments[i] = std::make_unique<juce::ParameterAttachment> (*parameters[i], [this, i] (float newFrequency) {
+            bandFrequencies[i] = newFrequency;
+            invalidateStaticLayer();
+        });
+        frequencyAttachments[i]->sendInitialUpdate();
     }
-
-    setCrossoverFrequencies (bandFrequencies[0], bandFrequencies[1], bandFrequencies[2]);
-    isPrepared = true;
 }
 
-void MultibandWidget::setCrossoverFrequencies (float f1, float f2, float f3)
+void MultibandWidget::setNumBands (int newNumBands)
 {
-    bandFrequencies[0] = f1;
-    bandFrequencies[1] = f2;
-    bandFrequencies[2] = f3;
-
-    for (int ch = 0; ch < 2; ++ch)
+    // Un séparateur qui disparaît pendant qu'on le tire termine son geste
+    if (draggingIndex >= newNumBands - 1)
     {
-        *lowPass1[ch].coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass (sampleRate, f1);
-        *highPass1[ch].coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass (sampleRate, f1);
-
-        *lowPass2[ch].coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass (sampleRate, f2);
-        *highPass2[ch].coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass (sampleRate, f2);
+        if (auto& attachment = frequencyAttachments[(size_t) draggingIndex])
+            attachment->endGesture();
 
-        *lowPass3[ch].coefficients = *juce::dsp::IIR::Coefficients<float>::makeLowPass (sampleRate, f3);
-        *highPass3[ch].coefficients = *juce::dsp::IIR::Coefficients<float>::makeHighPass (sampleRate, f3);
+        draggingIndex = -1;
     }
+
+    numBands = juce::jlimit (BandCount::min, BandCount::max, newNumBands);
+    invalidateStaticLayer();
 }
 
-void MultibandWidget::process (const juce::AudioBuffer<float>& input,
-    juce::AudioBuffer<float>& low,
-    juce::AudioBuffer<float>& midLow,
-    juce::AudioBuffer<float>& midHigh,
-    juce::AudioBuffer<float>& high)
+void MultibandWidget::setAnalysisEngine (AnalysisEngine* engineToUse)
 {
-    jassert (isPrepared);
-    const int numSamples = input.getNumSamples();
-
-    low.setSize (2, numSamples);
-    midLow.setSize (2, numSamples);
-    midHigh.setSize (2, numSamples);
-    high.setSize (2, numSamples);
+    analysisEngine = engineToUse;
+}
 
-    low.makeCopyOf (input);
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        auto block = juce::dsp::AudioBlock<float> (low).getSingleChannelBlock (ch);
-        lowPass1[ch].process (juce::dsp::ProcessContextReplacing<float> (block));
-    }
+void MultibandWidget::updateSpectrum()
+{
+    // Pas de nouvelle trame : rien à redessiner
+    if (analysisEngine == nullptr || ! analysisEngine->acquireSpectrum())
+        return;
 
-    high.makeCopyOf (input);
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        auto block = juce::dsp::AudioBlock<float> (high).getSingleChannelBlock (ch);
-        highPass3[ch].process (juce::dsp::ProcessContextReplacing<float> (block));
-    }
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsedSeconds = (float) juce::jlimit (0.0, 0.1, (now - lastSpectrumTime) * 0.001);
+    lastSpectrumTime = now;
 
-    juce::AudioBuffer<float> mid;
-    mid.makeCopyOf (input);
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        float* m = mid.getWritePointer (ch);
-        const float* l = low.getReadPointer (ch);
-        const float* h = high.getReadPointer (ch);
-        for (int i = 0; i < numSamples; ++i)
-            m[i] -= (l[i] + h[i]);
-    }
-    midLow.makeCopyOf (mid);
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        auto block = juce::dsp::AudioBlock<float> (midLow).getSingleChannelBlock (ch);
-        lowPass2[ch].process (juce::dsp::ProcessContextReplacing<float> (block));
-    }
+    const auto& frame = analysisEngine->getSpectrum();
+    for (size_t c = 0; c < spectrumBinnings.size(); ++c)
+        spectrumBinnings[c].update (frame.decibels[c].data(), frame.numBins, frame.sampleRate, frame.fftSize, elapsedSeconds);
 
-    midHigh.makeCopyOf (mid);
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        float* mh = midHigh.getWritePointer (ch);
-        const float* ml = midLow.getReadPointer (ch);
-        for (int i = 0; i < numSamples; ++i)
-            mh[i] -= ml[i];
-    }
+    // Le calque statique est recomposé sous la zone, il n'est pas redessiné
+    const auto newArea = getSpectrumArea();
+    repaint (spectrumArea.getUnion (newArea));
+    spectrumArea = newArea;
 }
 
-void MultibandWidget::setBufferToDisplay (const juce::AudioBuffer<float>* bufferToUse, std::mutex* mutexToUse)
+juce::Rectangle<int> MultibandWidget::getSpectrumArea() const
 {
-    scopeBuffer = bufferToUse;
-    scopeMutex = mutexToUse;
+    // Les valeurs sont bornées à [floorDecibels, 0] : le tracé tient entre la plus
+    // haute et la plus basse, plus l'épaisseur du trait et les jointures en pointe
+    auto lowest = 0.0f;
+    auto highest = SpectrumBinning::floorDecibels;
+    bool isEmpty = true;
+
+    const auto include = [&] (const std::vector<float>& values) {
+        for (auto value : values)
+        {
+            lowest = juce::jmin (lowest, value);
+            highest = juce::jmax (highest, value);
+            isEmpty = false;
+        }
+    };
+
+    for (auto& binning : spectrumBinnings)
+        include (binning.getLevels());
+
+    include (spectrumBinnings[0].getPeaks());
+
+    if (isEmpty)
+        return {};
+
+    constexpr float strokeMargin = 4.0f;
+    const auto top = (int) std::floor (decibelsToY (highest) - strokeMargin);
+    const auto bottom = (int) std::ceil (decibelsToY (lowest) + strokeMargin);
+    return getLocalBounds().withTop (top).withBottom (bottom).getIntersection (getLocalBounds());
 }
 
-void MultibandWidget::timerCallback()
+float MultibandWidget::decibelsToY (float decibels) const
 {
-    computeFFT();
-    repaint();
+    return juce::jmap (juce::jlimit (SpectrumBinning::floorDecibels, 0.0f, decibels), SpectrumBinning::floorDecibels, 0.0f, (float) getHeight(), 0.0f);
 }
 
-void MultibandWidget::computeFFT()
+void MultibandWidget::showAnalysisMenu()
 {
-    if (scopeBuffer == nullptr || scopeMutex == nullptr)
+    if (analysisEngine == nullptr)
         return;
 
-    std::scoped_lock lock (*scopeMutex);
+    juce::PopupMenu sizes;
+    for (int order = AnalysisEngine::minFftOrder; order <= AnalysisEngine::maxFftOrder; ++order)
+        sizes.addItem (juce::String (1 << order), true, analysisEngine->getFftOrder() == order, [this, order] { analysisEngine->setFftOrder (order); });
 
-    if (scopeBuffer->getNumSamples() < fftSize)
-        return;
+    juce::PopupMenu overlaps;
+    for (int overlap : { 1, 2, 4, 8 })
+        overlaps.addItem (juce::String (overlap) + "x", true, analysisEngine->getOverlap() == overlap, [this, overlap] { analysisEngine->setOverlap (overlap); });
 
-    auto* channelData = scopeBuffer->getReadPointer (0);
+    using Mode = AnalysisEngine::ChannelMode;
+    const auto mode = analysisEngine->getChannelMode();
 
-    std::fill (fftData.begin(), fftData.end(), 0.0f);
-    std::copy (channelData, channelData + fftSize, fftData.begin());
+    juce::PopupMenu menu;
+    menu.addSubMenu ("FFT size", sizes);
+    menu.addSubMenu ("Overlap", overlaps);
+    menu.addSeparator();
+    menu.addItem ("Mid / Side", true, mode == Mode::midSide, [this] { analysisEngine->setChannelMode (Mode::midSide); });
+    menu.addItem ("Left / Right", true, mode == Mode::leftRight, [this] { analysisEngine->setChannelMode (Mode::leftRight); });
 
-    juce::dsp::WindowingFunction<float> window (fftSize, juce::dsp::WindowingFunction<float>::hann, false);
-    window.multiplyWithWindowingTable (fftData.data(), fftSize);
+    menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (this));
+}
 
-    forwardFFT.performFrequencyOnlyForwardTransform (fftData.data());
+void MultibandWidget::paint (juce::Graphics& g)
+{
+    // Recréé à la résolution physique (l'échelle change d'un écran à l'autre)
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (! staticLayer.isValid() || scale != staticLayerScale)
+        renderStaticLayer (scale);
 
-    for (int i = 0; i < fftSize / 2; ++i)
-    {
-        auto db = juce::Decibels::gainToDecibels (fftData[i]);
-        magnitudes[i] = juce::jmap (db, -100.0f, 0.0f, 0.0f, 1.0f);
-    }
+    // Seule la région à redessiner (le plus souvent la zone du spectre) est recopiée
+    g.drawImage (staticLayer, getLocalBounds().toFloat());
+    drawSpectrum (g);
 }
 
-void MultibandWidget::paint (juce::Graphics& g)
+void MultibandWidget::resized()
 {
+    // Une colonne par pixel, sur la même échelle que frequencyToX
+    for (auto& binning : spectrumBinnings)
+        binning.setLayout (getWidth(), 20.0f, 20000.0f);
+
+    spectrumArea = {};
+    invalidateStaticLayer();
+}
+
+void MultibandWidget::invalidateStaticLayer()
+{
+    staticLayer = {};
+    repaint();
+}
+
+void MultibandWidget::renderStaticLayer (float scale)
+{
+    staticLayerScale = scale;
+
+    const auto width = juce::jmax (1, juce::roundToInt ((float) getWidth() * scale));
+    const auto height = juce::jmax (1, juce::roundToInt ((float) getHeight() * scale));
+    staticLayer = juce::Image (juce::Image::ARGB, width, height, true);
+
+    juce::Graphics g (staticLayer);
+    g.addTransform (juce::AffineTransform::scale (scale));
     drawBackgroundAndShadow (g);
     drawBands (g);
     drawSeparators (g);
     drawFrequencies (g);
-    drawSpectrum (g);
 }
 
 void MultibandWidget::drawBackgroundAndShadow (juce::Graphics& g)
@@ -172,38 +181,26 @@ void MultibandWidget::drawBackgroundAndShadow (juce::Graphics& g)
 
 void MultibandWidget::drawBands (juce::Graphics& g)
 {
-    juce::Colour colours[] = {
-        juce::Colour::fromRGBA (255, 60, 60, 80), // Rouge
-        juce::Colour::fromRGBA (255, 165, 0, 80), // Orange
-        juce::Colour::fromRGBA (50, 205, 50, 80), // Vert
-        juce::Colour::fromRGBA (70, 130, 180, 80) // Bleu
-    };
-
-    float x0 = 0.0f;
-    float x1 = frequencyToX (bandFrequencies[0]);
-    float x2 = frequencyToX (bandFrequencies[1]);
-    float x3 = frequencyToX (bandFrequencies[2]);
-    float x4 = (float) getWidth();
-
-    g.setColour (colours[0]);
-    g.fillRect (x0, 0.0f, x1 - x0, (float) getHeight());
+    // Du rouge (graves) au bleu (aigus), quel que soit le nombre de bandes
+    float left = 0.0f;
 
-    g.setColour (colours[1]);
-    g.fillRect (x1, 0.0f, x2 - x1, (float) getHeight());
-
-    g.setColour (colours[2]);
-    g.fillRect (x2, 0.0f, x3 - x2, (float) getHeight());
+    for (int b = 0; b < numBands; ++b)
+    {
+        const float right = b < getNumSeparators() ? frequencyToX (bandFrequencies[(size_t) b]) : (float) getWidth();
+        const float hue = 0.6f * (float) b / (float) (numBands - 1);
 
-    g.setColour (colours[3]);
-    g.fillRect (x3, 0.0f, x4 - x3, (float) getHeight());
+        g.setColour (juce::Colour::fromHSV (hue, 0.75f, 1.0f, 80.0f / 255.0f));
+        g.fillRect (left, 0.0f, right - left, (float) getHeight());
+        left = right;
+    }
 }
 
 void MultibandWidget::drawSeparators (juce::Graphics& g)
 {
     g.setColour (juce::Colours::darkcyan);
-    for (auto freq : bandFrequencies)
+    for (int i = 0; i < getNumSeparators(); ++i)
     {
-        auto x = frequencyToX (freq);
+        auto x = frequencyToX (bandFrequencies[(size_t) i]);
         g.drawLine (x, 0.0f, x, (float) getHeight(), 2.0f);
     }
 }
@@ -212,9 +209,9 @@ void MultibandWidget::drawFrequencies (juce::Graphics& g)
 {
     g.setFont (12.0f);
     g.setColour (juce::Colours::white);
-    for (int i = 0; i < bandFrequencies.size(); ++i)
+    for (int i = 0; i < getNumSeparators(); ++i)
     {
-        auto freq = bandFrequencies[i];
+        auto freq = bandFrequencies[(size_t) i];
         auto x = frequencyToX (freq);
         g.drawText (juce::String ((int) freq) + " Hz",
             (int) x - 25,
@@ -227,36 +224,54 @@ void MultibandWidget::drawFrequencies (juce::Graphics& g)
 
 void MultibandWidget::drawSpectrum (juce::Graphics& g)
 {
-    juce::Path spectrumPath;
-    auto width = getWidth();
-    auto height = getHeight();
+    if (analysisEngine == nullptr)
+        return;
+
+    // Un point par colonne, au centre du pixel
+    const auto makePath = [this] (const std::vector<float>& values) {
+        juce::Path path;
+        for (size_t x = 0; x < values.size(); ++x)
+        {
+            const auto point = juce::Point<float> ((float) x + 0.5f, decibelsToY (values[x]));
+            if (x == 0)
+                path.startNewSubPath (point);
+            else
+                path.lineTo (point);
+        }
+        return path;
+    };
 
-    spectrumPath.startNewSubPath (0.f, (float) height);
-    for (int i = 0; i < (int) magnitudes.size(); ++i)
+    const juce::Colour colours[] = { juce::Colours::white, juce::Colours::white.withAlpha (0.5f) };
+
+    for (size_t c = 0; c < spectrumBinnings.size(); ++c)
     {
-        float normX = (float) i / (float) magnitudes.size();
-        float x = normX * width;
-        float y = juce::jmap (magnitudes[i], 0.0f, 1.0f, (float) height, 0.0f);
-
-        if (i == 0)
-            spectrumPath.startNewSubPath (x, y);
-        else
-            spectrumPath.lineTo (x, y);
+        g.setColour (colours[c]);
+        g.strokePath (makePath (spectrumBinnings[c].getLevels()), juce::PathStrokeType (1.5f));
     }
-    g.setColour (juce::Colours::white);
-    g.strokePath (spectrumPath, juce::PathStrokeType (1.5f, juce::PathStrokeType::curved));
+
+    // Maintien de crête du premier canal
+    g.setColour (juce::Colours::white.withAlpha (0.3f));
+    g.strokePath (makePath (spectrumBinnings[0].getPeaks()), juce::PathStrokeType (1.0f));
 }
 
 void MultibandWidget::mouseDown (const juce::MouseEvent& e)
 {
+    if (e.mods.isPopupMenu())
+    {
+        showAnalysisMenu();
+        return;
+    }
+
     float mouseX = (float) e.x;
 
-    for (int i = 0; i < bandFrequencies.size(); ++i)
+    for (int i = 0; i < getNumSeparators(); ++i)
     {
-        float x = frequencyToX (bandFrequencies[i]);
+        float x = frequencyToX (bandFrequencies[(size_t) i]);
         if (std::abs (x - mouseX) < getSeparatorHitboxWidth())
         {
             draggingIndex = i;
+            if (auto& attachment = frequencyAttachments[(size_t) i])
+                attachment->beginGesture();
             break;
         }
     }
@@ -269,19 +284,28 @@ void MultibandWidget::mouseDrag (const juce::MouseEvent& e)
 
     float newFreq = xToFrequency ((float) e.x);
 
-    // Contraintes pour ne pas dpasser les autres sparateurs
+    // Contraintes pour ne pas dépasser les autres séparateurs
     if (draggingIndex > 0)
-        newFreq = std::max (newFreq, bandFrequencies[draggingIndex - 1] + 10.0f);
-    if (draggingIndex < (int) bandFrequencies.size() - 1)
-        newFreq = std::min (newFreq, bandFrequencies[draggingIndex + 1] - 10.0f);
+        newFreq = std::max (newFreq, bandFrequencies[(size_t) draggingIndex - 1] + 10.0f);
+    if (draggingIndex < getNumSeparators() - 1)
+        newFreq = std::min (newFreq, bandFrequencies[(size_t) draggingIndex + 1] - 10.0f);
 
-    bandFrequencies[draggingIndex] = juce::jlimit (20.0f, 20000.0f, newFreq);
-    setCrossoverFrequencies (bandFrequencies[0], bandFrequencies[1], bandFrequencies[2]);
+    bandFrequencies[(size_t) draggingIndex] = juce::jlimit (20.0f, 20000.0f, newFreq);
 
-    if (onFrequenciesChanged)
-        onFrequenciesChanged (bandFrequencies[0], bandFrequencies[1], bandFrequencies[2]);
+    // Le processeur suit le paramètre, avec lissage côté audio
+    if (auto& attachment = frequencyAttachments[(size_t) draggingIndex])
+        attachment->setValueAsPartOfGesture (bandFrequencies[(size_t) draggingIndex]);
 
-    repaint();
+    invalidateStaticLayer();
+}
+
+void MultibandWidget::mouseUp (const juce::MouseEvent&)
+{
+    if (draggingIndex >= 0)
+        if (auto& attachment = frequencyAttachments[(size_t) draggingIndex])
+            attachment->endGesture();
+
+    draggingIndex = -1;
 }
 
 float MultibandWidget::frequencyToX (float freq) const
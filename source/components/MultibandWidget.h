@@ -1,79 +1,83 @@
 #pragma once
 
 #include <array>
-#include <functional>
+#include <memory>
+#include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_gui_extra/juce_gui_extra.h>
-#include <mutex>
 #include <vector>
+#include "../dsp/AnalysisEngine.h"
+#include "../dsp/CrossoverEngine.h"
+#include "SpectrumBinning.h"
 
-class MultibandWidget : public juce::Component,
-                        private juce::Timer
+class MultibandWidget : public juce::Component
 {
 public:
     MultibandWidget();
 
-    // Prpare le processeur audio ( appeler avant process)
-    void prepare (const juce::dsp::ProcessSpec& spec);
+    static constexpr int maxCrossovers = BandCount::maxCrossovers;
 
-    // Traite l'input en 4 bandes
-    void process (const juce::AudioBuffer<float>& input,
-        juce::AudioBuffer<float>& low,
-        juce::AudioBuffer<float>& midLow,
-        juce::AudioBuffer<float>& midHigh,
-        juce::AudioBuffer<float>& high);
+    // Relie les séparateurs aux paramètres XOVER1..7 (le DSP vit dans CrossoverEngine)
+    void attachToParameters (const std::array<juce::RangedAudioParameter*, maxCrossovers>& parameters);
 
-    // Rcuprer le buffer pour visualisation (optionnel)
-    void setBufferToDisplay (const juce::AudioBuffer<float>* bufferToUse, std::mutex* mutexToUse);
+    // Seuls les numBands - 1 premiers séparateurs sont affichés et déplaçables
+    void setNumBands (int newNumBands);
 
-    // Callback quand les frquences changent (f1, f2, f3)
-    std::function<void (float, float, float)> onFrequenciesChanged;
+    // Source du spectre affiché (optionnelle). Le clic droit règle l'analyse.
+    void setAnalysisEngine (AnalysisEngine* engineToUse);
+
+    // À chaque trame de l'éditeur (FrameScheduler) : récupère le dernier spectre
+    void updateSpectrum();
 
     // Comportement du composant
     void paint (juce::Graphics& g) override;
+    void resized() override;
     void mouseDown (const juce::MouseEvent& e) override;
     void mouseDrag (const juce::MouseEvent& e) override;
+    void mouseUp (const juce::MouseEvent& e) override;
 
 private:
-    // Frquences de sparation des bandes
-    std::vector<float> bandFrequencies { 200.f, 1000.f, 5000.f };
+    // Fréquences de séparation des bandes (toutes, y compris les inactives)
+    std::array<float, maxCrossovers> bandFrequencies { 200.f, 1000.f, 5000.f, 8000.f, 11000.f, 14000.f, 17000.f };
+    int numBands = 4;
     int draggingIndex = -1;
 
-    // Fonctions de dessin (dcomposes depuis paint)
+    int getNumSeparators() const { return numBands - 1; }
+
+    std::array<std::unique_ptr<juce::ParameterAttachment>, maxCrossovers> frequencyAttachments;
+
+    // Calque statique (fond, ombre, bandes, séparateurs, fréquences) rendu dans
+    // une image à la résolution de l'écran. Il n'est redessiné qu'après un
+    // redimensionnement ou un changement des bandes (séparateur déplacé, nombre
+    // de bandes) ; à chaque trame, seul le spectre est redessiné.
+    juce::Image staticLayer;
+    float staticLayerScale = 0.0f;
+    void invalidateStaticLayer();
+    void renderStaticLayer (float scale);
+
+    // Zone occupée par le spectre à la dernière trame : la suivante ne
+    // redessine que son union avec la nouvelle
+    juce::Rectangle<int> spectrumArea;
+    juce::Rectangle<int> getSpectrumArea() const;
+    float decibelsToY (float decibels) const;
+
+    // Fonctions de dessin (décomposées depuis paint)
     void drawBackgroundAndShadow (juce::Graphics& g);
     void drawBands (juce::Graphics& g);
     void drawSeparators (juce::Graphics& g);
     void drawFrequencies (juce::Graphics& g);
     void drawSpectrum (juce::Graphics& g);
 
-    // Traitement audio
-    float sampleRate = 44100.f;
-    bool isPrepared = false;
-
-    juce::dsp::IIR::Filter<float> lowPass1[2]; // freq1
-    juce::dsp::IIR::Filter<float> highPass1[2];
-    juce::dsp::IIR::Filter<float> lowPass2[2]; // freq2
-    juce::dsp::IIR::Filter<float> highPass2[2];
-    juce::dsp::IIR::Filter<float> lowPass3[2]; // freq3
-    juce::dsp::IIR::Filter<float> highPass3[2];
-
-    void setCrossoverFrequencies (float f1, float f2, float f3);
-
-    // FFT display
-    const juce::AudioBuffer<float>* scopeBuffer = nullptr;
-    std::mutex* scopeMutex = nullptr;
-
-    static constexpr int fftOrder = 9;
-    static constexpr int fftSize = 1 << fftOrder;
+    // Spectre calculé sur le thread d'analyse ; on ne fait ici que le dessiner
+    AnalysisEngine* analysisEngine = nullptr;
 
-    juce::dsp::FFT forwardFFT { fftOrder };
-    std::array<float, fftSize * 2> fftData {};
-    std::array<float, fftSize / 2> magnitudes {};
+    // Spectre ramené à une valeur lissée par colonne de pixels (mid/side ou L/R)
+    std::array<SpectrumBinning, 2> spectrumBinnings;
+    double lastSpectrumTime = 0.0;
 
-    void timerCallback() override;
-    void computeFFT();
+    void showAnalysisMenu();
 
-    // Conversion helper pour les frquences ? positions
+    // Conversion helper pour les fréquences ? positions
     float frequencyToX (float freq) const;
     float xToFrequency (float x) const;
     float getSeparatorHitboxWidth() const { return 8.0f; }
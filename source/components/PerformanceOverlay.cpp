@@ -0,0 +1,79 @@
+#include "PerformanceOverlay.h"
+
+PerformanceOverlay::PerformanceOverlay()
+{
+    setInterceptsMouseClicks (true, false);
+}
+
+void PerformanceOverlay::setSnapshot (const PerformanceMonitor::Snapshot& newSnapshot)
+{
+    // Aucun bloc traité depuis la dernière trame : rien à redessiner
+    if (newSnapshot.numBlocks == snapshot.numBlocks && newSnapshot.averageLoad == snapshot.averageLoad)
+        return;
+
+    snapshot = newSnapshot;
+    repaint();
+}
+
+void PerformanceOverlay::mouseDown (const juce::MouseEvent&)
+{
+    if (onReset)
+        onReset();
+}
+
+void PerformanceOverlay::paint (juce::Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+
+    g.setColour (juce::Colours::black.withAlpha (0.75f));
+    g.fillRoundedRectangle (area, 6.0f);
+
+    area = area.reduced (8.0f);
+    const auto percent = [] (float load) { return juce::String (load * 100.0f, 1) + " %"; };
+
+    static constexpr const char* stageNames[] = { "split", "width", "analysis" };
+    static_assert (std::size (stageNames) == PerformanceMonitor::numStages);
+
+    juce::StringArray lines;
+    lines.add ("DSP load " + percent (snapshot.averageLoad) + "  peak " + percent (snapshot.peakLoad));
+
+    juce::String stages;
+    for (int s = 0; s < PerformanceMonitor::numStages; ++s)
+        stages << stageNames[s] << " " << percent (snapshot.stageLoads[(size_t) s]) << "  ";
+    lines.add (stages.trimEnd());
+
+    lines.add ("blocks " + juce::String ((juce::int64) snapshot.numBlocks) + "  overruns " + juce::String ((juce::int64) snapshot.numOverruns));
+
+    g.setFont (12.0f);
+    g.setColour (snapshot.numOverruns > 0 ? juce::Colours::orange : juce::Colours::white);
+
+    for (auto& line : lines)
+        g.drawText (line, area.removeFromTop (16.0f), juce::Justification::centredLeft);
+
+    drawHistogram (g, area.withTrimmedTop (4.0f));
+}
+
+void PerformanceOverlay::drawHistogram (juce::Graphics& g, juce::Rectangle<float> area)
+{
+    juce::uint32 highest = 1;
+    for (auto count : snapshot.histogram)
+        highest = juce::jmax (highest, count);
+
+    const auto binWidth = area.getWidth() / (float) PerformanceMonitor::numHistogramBins;
+
+    for (int b = 0; b < PerformanceMonitor::numHistogramBins; ++b)
+    {
+        // Hauteur logarithmique : les rares blocs lents restent visibles
+        const auto count = snapshot.histogram[(size_t) b];
+        const auto height = count == 0 ? 0.0f : area.getHeight() * std::log1p ((float) count) / std::log1p ((float) highest);
+        const bool overBudget = (float) b * PerformanceMonitor::histogramBinWidth >= 1.0f;
+
+        g.setColour (overBudget ? juce::Colours::red : juce::Colours::deepskyblue);
+        g.fillRect (area.getX() + (float) b * binWidth + 1.0f, area.getBottom() - height, binWidth - 2.0f, height);
+    }
+
+    // Limite du budget
+    const auto budgetX = area.getX() + binWidth / PerformanceMonitor::histogramBinWidth;
+    g.setColour (juce::Colours::white.withAlpha (0.5f));
+    g.drawVerticalLine ((int) budgetX, area.getY(), area.getBottom());
+}
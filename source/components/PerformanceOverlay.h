@@ -0,0 +1,27 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../dsp/PerformanceMonitor.h"
+
+// Superposition optionnelle de l'éditeur : charge moyenne et crête du thread
+// audio, part de chaque étape, dépassements et histogramme des charges par bloc.
+class PerformanceOverlay : public juce::Component
+{
+public:
+    PerformanceOverlay();
+
+    void setSnapshot (const PerformanceMonitor::Snapshot& newSnapshot);
+
+    void paint (juce::Graphics& g) override;
+
+    // Clic : remet les statistiques à zéro
+    std::function<void()> onReset;
+    void mouseDown (const juce::MouseEvent&) override;
+
+private:
+    PerformanceMonitor::Snapshot snapshot;
+
+    void drawHistogram (juce::Graphics& g, juce::Rectangle<float> area);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceOverlay)
+};
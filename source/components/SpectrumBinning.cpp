@@ -0,0 +1,111 @@
+#include "SpectrumBinning.h"
+#include <algorithm>
+#include <cmath>
+
+void SpectrumBinning::setLayout (int newNumColumns, float newMinFrequency, float newMaxFrequency)
+{
+    newNumColumns = std::max (0, newNumColumns);
+
+    if (newNumColumns == numColumns && newMinFrequency == minFrequency && newMaxFrequency == maxFrequency)
+        return;
+
+    numColumns = newNumColumns;
+    minFrequency = newMinFrequency;
+    maxFrequency = newMaxFrequency;
+
+    // Force le recalcul de la table à la prochaine trame
+    mappedFftSize = 0;
+    columns.resize ((size_t) numColumns);
+    levels.resize ((size_t) numColumns);
+    peaks.resize ((size_t) numColumns);
+    peakAges.resize ((size_t) numColumns);
+    reset();
+}
+
+void SpectrumBinning::setBallistics (float newAttackSeconds, float newReleaseSeconds, float newPeakHoldSeconds, float newPeakFallDecibelsPerSecond)
+{
+    attackSeconds = newAttackSeconds;
+    releaseSeconds = newReleaseSeconds;
+    peakHoldSeconds = newPeakHoldSeconds;
+    peakFallDecibelsPerSecond = newPeakFallDecibelsPerSecond;
+}
+
+void SpectrumBinning::reset()
+{
+    std::fill (levels.begin(), levels.end(), floorDecibels);
+    std::fill (peaks.begin(), peaks.end(), floorDecibels);
+    std::fill (peakAges.begin(), peakAges.end(), 0.0f);
+}
+
+void SpectrumBinning::updateMapping (double sampleRate, int fftSize)
+{
+    mappedSampleRate = sampleRate;
+    mappedFftSize = fftSize;
+
+    const auto binsPerHertz = (double) fftSize / sampleRate;
+    const auto ratio = (double) maxFrequency / minFrequency;
+
+    // Fréquence au bord gauche d'une colonne (x = column)
+    const auto edgeFrequency = [&] (double x) { return minFrequency * std::pow (ratio, x / numColumns); };
+
+    for (int c = 0; c < numColumns; ++c)
+    {
+        const auto low = edgeFrequency (c) * binsPerHertz;
+        const auto high = edgeFrequency (c + 1) * binsPerHertz;
+
+        auto& column = columns[(size_t) c];
+        column.firstBin = (int) std::ceil (low);
+        column.lastBin = (int) std::ceil (high) - 1;
+        column.position = (float) (edgeFrequency (c + 0.5) * binsPerHertz);
+    }
+}
+
+float SpectrumBinning::aggregate (const Column& column, const float* decibels, int numBins) const noexcept
+{
+    // Aucun bin dans la colonne : interpolation entre les deux bins voisins
+    if (column.lastBin < column.firstBin)
+    {
+        const auto index = std::min ((int) column.position, numBins - 2);
+        const auto frac = std::min (column.position - (float) index, 1.0f);
+        return decibels[index] + frac * (decibels[index + 1] - decibels[index]);
+    }
+
+    // Plusieurs bins : on garde le maximum pour ne pas écraser les raies
+    const auto first = std::min (column.firstBin, numBins - 1);
+    const auto last = std::min (column.lastBin, numBins - 1);
+    return *std::max_element (decibels + first, decibels + last + 1);
+}
+
+void SpectrumBinning::update (const float* decibels, int numBins, double sampleRate, int fftSize, float elapsedSeconds)
+{
+    if (numColumns == 0 || numBins < 2)
+        return;
+
+    if (fftSize != mappedFftSize || sampleRate != mappedSampleRate)
+        updateMapping (sampleRate, fftSize);
+
+    const auto attack = 1.0f - std::exp (-elapsedSeconds / attackSeconds);
+    const auto release = 1.0f - std::exp (-elapsedSeconds / releaseSeconds);
+    const auto peakFall = peakFallDecibelsPerSecond * elapsedSeconds;
+
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        const auto target = std::max (aggregate (columns[c], decibels, numBins), floorDecibels);
+
+        auto& level = levels[c];
+        level += (target > level ? attack : release) * (target - level);
+
+        auto& peak = peaks[c];
+        auto& age = peakAges[c];
+
+        if (level >= peak)
+        {
+            peak = level;
+            age = 0.0f;
+        }
+        else if ((age += elapsedSeconds) > peakHoldSeconds)
+        {
+            peak = std::max (peak - peakFall, level);
+        }
+    }
+}
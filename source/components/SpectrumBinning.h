@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+// Regroupe les bins d'une FFT en colonnes de pixels sur une échelle
+// logarithmique (la même que frequencyToX) puis applique un lissage
+// attaque / relâchement et un maintien de crête.
+// La table bin -> colonne n'est recalculée que si la largeur, la taille de FFT
+// ou la fréquence d'échantillonnage change : le coût du dessin ne dépend plus
+// que de la largeur du composant.
+class SpectrumBinning
+{
+public:
+    static constexpr float floorDecibels = -100.0f;
+
+    void setLayout (int newNumColumns, float newMinFrequency, float newMaxFrequency);
+
+    void setBallistics (float newAttackSeconds, float newReleaseSeconds, float newPeakHoldSeconds, float newPeakFallDecibelsPerSecond);
+
+    // decibels : numBins valeurs en dB, bin i à i * sampleRate / fftSize Hz.
+    // elapsedSeconds : temps écoulé depuis la trame précédente.
+    void update (const float* decibels, int numBins, double sampleRate, int fftSize, float elapsedSeconds);
+
+    void reset();
+
+    int getNumColumns() const noexcept { return numColumns; }
+    const std::vector<float>& getLevels() const noexcept { return levels; }
+    const std::vector<float>& getPeaks() const noexcept { return peaks; }
+
+private:
+    // Une colonne couvre les bins [firstBin, lastBin]. Aux basses fréquences,
+    // plusieurs colonnes tombent entre deux bins : on interpole alors à position.
+    struct Column
+    {
+        int firstBin = 0;
+        int lastBin = -1;
+        float position = 0.0f;
+    };
+
+    int numColumns = 0;
+    float minFrequency = 20.0f;
+    float maxFrequency = 20000.0f;
+
+    float attackSeconds = 0.01f;
+    float releaseSeconds = 0.3f;
+    float peakHoldSeconds = 1.5f;
+    float peakFallDecibelsPerSecond = 20.0f;
+
+    double mappedSampleRate = 0.0;
+    int mappedFftSize = 0;
+    std::vector<Column> columns;
+
+    std::vector<float> levels;
+    std::vector<float> peaks;
+    std::vector<float> peakAges;
+
+    void updateMapping (double sampleRate, int fftSize);
+    float aggregate (const Column& column, const float* decibels, int numBins) const noexcept;
+};
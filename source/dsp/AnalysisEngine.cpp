@@ -0,0 +1,185 @@
+#include "AnalysisEngine.h"
+
+AnalysisEngine::AnalysisEngine() = default;
+
+AnalysisEngine::~AnalysisEngine()
+{
+    setActive (false);
+}
+
+void AnalysisEngine::setActive (bool shouldBeActive)
+{
+    if (shouldBeActive == active)
+        return;
+
+    active = shouldBeActive;
+
+    if (shouldBeActive)
+    {
+        // Le thread d'analyse ne sert pas encore ce moteur : rien ne lit ces buffers
+        if (! allocated)
+            allocate();
+
+        channel.setConsumerActive (true);
+        silenceDetector.reset();
+        silent.store (false);
+        analysisService.emplace();
+        (*analysisService)->addClient (*this);
+    }
+    else
+    {
+        (*analysisService)->removeClient (*this);
+        analysisService.reset();
+        channel.setConsumerActive (false);
+    }
+}
+
+void AnalysisEngine::allocate()
+{
+    incoming.setSize (2, historySize);
+    history.setSize (2, historySize);
+    history.clear();
+    fftData.assign ((size_t) historySize * 2, 0.0f);
+
+    for (int order = minFftOrder; order <= maxFftOrder; ++order)
+    {
+        const auto index = (size_t) (order - minFftOrder);
+        const auto fftSize = (size_t) 1 << order;
+
+        ffts[index] = std::make_unique<juce::dsp::FFT> (order);
+        windows[index].resize (fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (windows[index].data(), fftSize, juce::dsp::WindowingFunction<float>::hann, false);
+    }
+
+    spectra.forEachBuffer ([] (SpectrumFrame& frame) {
+        for (auto& decibels : frame.decibels)
+            decibels.assign ((size_t) historySize / 2, -120.0f);
+    });
+
+    scopeWindows.forEachBuffer ([] (ScopeWindow& window) {
+        window.samples.setSize (2, scopeWindowSize);
+        window.samples.clear();
+    });
+
+    allocated = true;
+}
+
+const ScopeWindow& AnalysisEngine::acquireScopeWindow()
+{
+    scopeWindows.acquire();
+    return scopeWindows.getReadBuffer();
+}
+
+int AnalysisEngine::useTimeSlice()
+{
+    const int numRead = readIncomingSamples();
+
+    // Entrée silencieuse : le dernier spectre et le scope restent affichés tels quels
+    if (silent.load (std::memory_order_relaxed))
+        return 20;
+
+    if (numRead > 0)
+        publishScopeWindow();
+
+    const int hopSize = (1 << fftOrder.load()) / overlap.load();
+    if (samplesSinceLastFrame >= hopSize)
+    {
+        // Seule la trame la plus récente est utile à l'affichage
+        computeSpectrum();
+        samplesSinceLastFrame %= hopSize;
+    }
+
+    return 5;
+}
+
+int AnalysisEngine::readIncomingSamples()
+{
+    int total = 0;
+
+    while (const int numSamples = channel.read (incoming))
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            const int chunk = juce::jmin (numSamples - start, historySize - historyWritePosition);
+
+            for (int ch = 0; ch < history.getNumChannels(); ++ch)
+                history.copyFrom (ch, historyWritePosition, incoming, ch, start, chunk);
+
+            historyWritePosition = (historyWritePosition + chunk) % historySize;
+            start += chunk;
+        }
+
+        silenceDetector.update (incoming, numSamples, sampleRate.load());
+        total += numSamples;
+    }
+
+    silent.store (silenceDetector.isSilent(), std::memory_order_relaxed);
+
+    totalSamplesRead += total;
+    samplesSinceLastFrame = juce::jmin (samplesSinceLastFrame + total, historySize);
+    return total;
+}
+
+void AnalysisEngine::publishScopeWindow()
+{
+    auto& window = scopeWindows.getWriteBuffer();
+    const int start = (historyWritePosition - scopeWindowSize + historySize) % historySize;
+    const int firstPart = juce::jmin (scopeWindowSize, historySize - start);
+
+    for (int ch = 0; ch < window.samples.getNumChannels(); ++ch)
+    {
+        window.samples.copyFrom (ch, 0, history, ch, start, firstPart);
+        if (firstPart < scopeWindowSize)
+            window.samples.copyFrom (ch, firstPart, history, ch, 0, scopeWindowSize - firstPart);
+    }
+
+    window.endSample = totalSamplesRead;
+    scopeWindows.publish();
+}
+
+void AnalysisEngine::computeSpectrum()
+{
+    const int order = fftOrder.load();
+    const int fftSize = 1 << order;
+    const auto index = (size_t) (order - minFftOrder);
+    const bool isMidSide = channelMode.load() == ChannelMode::midSide;
+
+    const auto* window = windows[index].data();
+    const auto* left = history.getReadPointer (0);
+    const auto* right = history.getReadPointer (1);
+    const int start = (historyWritePosition - fftSize + historySize) % historySize;
+
+    // Gain cohérent de la fenêtre de Hann (0.5) et spectre unilatéral (x2)
+    const float scale = 4.0f / (float) fftSize;
+
+    auto& frame = spectra.getWriteBuffer();
+    frame.sampleRate = sampleRate.load();
+    frame.fftSize = fftSize;
+    frame.numBins = fftSize / 2;
+    frame.isMidSide = isMidSide;
+
+    for (size_t c = 0; c < frame.decibels.size(); ++c)
+    {
+        for (int i = 0; i < fftSize; ++i)
+        {
+            const int n = (start + i) % historySize;
+            float sample;
+
+            if (isMidSide)
+                sample = c == 0 ? 0.5f * (left[n] + right[n]) : 0.5f * (left[n] - right[n]);
+            else
+                sample = c == 0 ? left[n] : right[n];
+
+            fftData[(size_t) i] = sample * window[i];
+        }
+
+        std::fill (fftData.begin() + fftSize, fftData.begin() + 2 * fftSize, 0.0f);
+        ffts[index]->performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+        auto& decibels = frame.decibels[c];
+        for (int bin = 0; bin < frame.numBins; ++bin)
+            decibels[(size_t) bin] = juce::Decibels::gainToDecibels (fftData[(size_t) bin] * scale, -120.0f);
+    }
+
+    spectra.publish();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "AnalysisService.h"
+#include "ScopeChannel.h"
+#include "SilenceDetector.h"
+#include "TripleBuffer.h"
+
+// Spectre publié par l'AnalysisEngine, en dB par bin (préalloué à la taille maximale)
+struct SpectrumFrame
+{
+    double sampleRate = 44100.0;
+    int fftSize = 0;
+    int numBins = 0;
+    bool isMidSide = true;
+    std::array<std::vector<float>, 2> decibels; // mid/side ou L/R
+};
+
+// Dernières échantillons de sortie pour le scope. endSample compte les
+// échantillons depuis l'activation : l'affichage en déduit combien sont nouveaux.
+struct ScopeWindow
+{
+    juce::AudioBuffer<float> samples;
+    juce::int64 endSample = 0;
+};
+
+// Analyse de la sortie sur le thread d'arrière-plan partagé (AnalysisService).
+// Le thread audio pousse les échantillons dans un ScopeChannel ; le thread
+// d'analyse les accumule, calcule une FFT tous les fftSize / overlap
+// échantillons et publie le spectre et la fenêtre du scope sans verrou.
+// Rien ne tourne ni n'est alloué tant qu'aucun éditeur n'a appelé
+// setActive (true), et plus rien n'est publié quand l'entrée est silencieuse
+// (voir SilenceDetector).
+class AnalysisEngine : private juce::TimeSliceClient
+{
+public:
+    static constexpr int minFftOrder = 9;
+    static constexpr int maxFftOrder = 14;
+    static constexpr int scopeWindowSize = 8192;
+
+    enum class ChannelMode
+    {
+        midSide,
+        leftRight
+    };
+
+    AnalysisEngine();
+    ~AnalysisEngine() override;
+
+    // Depuis prepareToPlay. Ne touche à aucun buffer.
+    void prepare (double newSampleRate) { sampleRate.store (newSampleRate); }
+
+    // Thread audio
+    template <typename SampleType>
+    void push (const juce::AudioBuffer<SampleType>& buffer) noexcept { channel.push (buffer); }
+
+    // Thread message. La première activation alloue les buffers d'analyse, conservés
+    // ensuite jusqu'à la destruction.
+    void setActive (bool shouldBeActive);
+    void setFftOrder (int newOrder) { fftOrder.store (juce::jlimit (minFftOrder, maxFftOrder, newOrder)); }
+    int getFftOrder() const { return fftOrder.load(); }
+    void setOverlap (int newOverlap) { overlap.store (juce::jlimit (1, 8, newOverlap)); }
+    int getOverlap() const { return overlap.load(); }
+    void setChannelMode (ChannelMode newMode) { channelMode.store (newMode); }
+    ChannelMode getChannelMode() const { return channelMode.load(); }
+
+    // Un seul thread consommateur (le thread message). Les références restent
+    // valides jusqu'au prochain acquire correspondant.
+    bool acquireSpectrum() { return spectra.acquire(); }
+    const SpectrumFrame& getSpectrum() const { return spectra.getReadBuffer(); }
+    const ScopeWindow& acquireScopeWindow();
+
+    // Vrai si la sortie est silencieuse depuis SilenceDetector::holdSeconds :
+    // spectre et scope sont figés, l'éditeur peut sauter ses trames
+    bool isSilent() const noexcept { return silent.load (std::memory_order_relaxed); }
+
+private:
+    static constexpr int historySize = 1 << maxFftOrder;
+    static constexpr int numOrders = maxFftOrder - minFftOrder + 1;
+
+    // Tenu seulement entre setActive (true) et setActive (false) : un processus
+    // sans éditeur (rendu hors ligne, tests) ne crée jamais le service
+    std::optional<juce::SharedResourcePointer<AnalysisService>> analysisService;
+    bool active = false;
+    bool allocated = false;
+    // Environ 170 ms à 192 kHz : bien plus que l'intervalle entre deux tranches du
+    // thread d'analyse, qui ne lit de toute façon que les historySize plus récents
+    ScopeChannel channel { 2, 2 * historySize };
+
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<int> fftOrder { 11 };
+    std::atomic<int> overlap { 2 };
+    std::atomic<ChannelMode> channelMode { ChannelMode::midSide };
+    std::atomic<bool> silent { false };
+
+    // Thread d'analyse uniquement
+    juce::AudioBuffer<float> incoming;
+    juce::AudioBuffer<float> history;
+    int historyWritePosition = 0;
+    juce::int64 totalSamplesRead = 0;
+    int samplesSinceLastFrame = 0;
+    SilenceDetector silenceDetector;
+    std::vector<float> fftData;
+
+    // FFT et fenêtre de Hann de chaque ordre
+    std::array<std::unique_ptr<juce::dsp::FFT>, numOrders> ffts;
+    std::array<std::vector<float>, numOrders> windows;
+
+    TripleBuffer<SpectrumFrame> spectra;
+    TripleBuffer<ScopeWindow> scopeWindows;
+
+    void allocate();
+    int useTimeSlice() override;
+    int readIncomingSamples();
+    void publishScopeWindow();
+    void computeSpectrum();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisEngine)
+};
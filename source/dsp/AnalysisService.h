@@ -0,0 +1,45 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Thread d'analyse commun à toutes les instances du plugin chargées dans le
+// processus. Chaque AnalysisEngine actif s'y inscrit comme TimeSliceClient :
+// quarante instances partagent un seul thread de FFT au lieu d'en lancer
+// quarante, et le thread ne tourne que tant qu'un éditeur est ouvert.
+//
+// À partager via juce::SharedResourcePointer<AnalysisService>, comme le
+// FrameScheduler côté affichage. Thread message uniquement.
+class AnalysisService
+{
+public:
+    AnalysisService() = default;
+
+    ~AnalysisService()
+    {
+        // Les moteurs se désinscrivent avant de relâcher leur SharedResourcePointer
+        jassert (thread.getNumClients() == 0);
+        thread.stopThread (1000);
+    }
+
+    void addClient (juce::TimeSliceClient& client)
+    {
+        thread.addTimeSliceClient (&client);
+
+        if (! thread.isThreadRunning())
+            thread.startThread (juce::Thread::Priority::low);
+    }
+
+    // Attend la fin d'un éventuel useTimeSlice en cours du client
+    void removeClient (juce::TimeSliceClient& client)
+    {
+        thread.removeTimeSliceClient (&client);
+
+        if (thread.getNumClients() == 0)
+            thread.stopThread (1000);
+    }
+
+private:
+    juce::TimeSliceThread thread { "SR23 Analysis" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisService)
+};
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include <type_traits>
+#include <utility>
+#include "LinkwitzRiley.h"
+
+// Nombre de bandes possible, choisi à l'exécution parmi des versions compilées
+namespace BandCount
+{
+    static constexpr int min = 2;
+    static constexpr int max = 8;
+    static constexpr int maxCrossovers = max - 1;
+
+    // Appelle fn (std::integral_constant<size_t, N>) avec N = numBands : le corps
+    // de fn est instancié pour chaque N, ses boucles sur les bandes sont déroulées.
+    template <typename Function>
+    inline void dispatch (int numBands, Function&& fn)
+    {
+        switch (numBands)
+        {
+            case 2: fn (std::integral_constant<size_t, 2> {}); break;
+            case 3: fn (std::integral_constant<size_t, 3> {}); break;
+            case 4: fn (std::integral_constant<size_t, 4> {}); break;
+            case 5: fn (std::integral_constant<size_t, 5> {}); break;
+            case 6: fn (std::integral_constant<size_t, 6> {}); break;
+            case 7: fn (std::integral_constant<size_t, 7> {}); break;
+            case 8: fn (std::integral_constant<size_t, 8> {}); break;
+            default: jassertfalse; break;
+        }
+    }
+}
+
+// Séparation Linkwitz-Riley en numBands bandes, en une passe par échantillon.
+//
+// Arbre binaire : chaque nœud coupe ses bandes en deux au point de séparation du
+// milieu, puis passe chaque branche par les passe-tout des points de séparation
+// de l'autre branche. Chaque bande voit ainsi une fois chaque point de séparation
+// (en passe-bas, passe-haut ou passe-tout) : la somme des bandes est un passe-tout
+// d'amplitude parfaitement plate. Pour 4 bandes : f2, puis AP(f3) + f1 à gauche,
+// AP(f1) + f3 à droite.
+//
+// SampleType (float ou double) est le type des échantillons et des états des
+// filtres ; les fréquences restent en float.
+template <size_t numBands, typename SampleType>
+class BandSplitter
+{
+public:
+    static_assert (numBands >= BandCount::min && numBands <= BandCount::max);
+
+    static constexpr size_t numCrossovers = numBands - 1;
+    static constexpr int maxChannels = 2;
+
+    // frequencies : au moins numCrossovers valeurs croissantes, sous Nyquist. Dans le
+    // plugin, PluginProcessor::getCrossoverFrequencies s'en charge ; dans le
+    // désordre, les bandes échangeraient leurs rôles sans que rien ne le signale.
+    void prepare (double newSampleRate, const float* frequencies, double smoothingTimeSeconds)
+    {
+        sampleRate = newSampleRate;
+        jassert (areValidFrequencies (frequencies));
+
+        for (size_t i = 0; i < numCrossovers; ++i)
+        {
+            smoothers[i].reset (sampleRate, smoothingTimeSeconds);
+            smoothers[i].setCurrentAndTargetValue (frequencies[i]);
+        }
+
+        updateCoefficients();
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channel : channels)
+            channel = {};
+    }
+
+    // Saute directement aux cibles, sans glissement (changement de nombre de bandes)
+    void snapToTargets() noexcept
+    {
+        for (auto& smoother : smoothers)
+            smoother.setCurrentAndTargetValue (smoother.getTargetValue());
+
+        updateCoefficients();
+    }
+
+    void setTargetFrequencies (const float* frequencies) noexcept
+    {
+        jassert (areValidFrequencies (frequencies));
+
+        for (size_t i = 0; i < numCrossovers; ++i)
+            smoothers[i].setTargetValue (frequencies[i]);
+    }
+
+    bool isSmoothing() const noexcept
+    {
+        for (auto& smoother : smoothers)
+            if (smoother.isSmoothing())
+                return true;
+
+        return false;
+    }
+
+    // Avance les glissements de numSamples et ne recalcule que les coefficients qui bougent
+    void advanceSmoothing (int numSamples) noexcept
+    {
+        for (size_t i = 0; i < numCrossovers; ++i)
+            if (smoothers[i].isSmoothing())
+                coefficients[i] = Coefficients::make (sampleRate, smoothers[i].skip (numSamples));
+    }
+
+    template <CrossoverSlope slope>
+    void process (const juce::dsp::AudioBlock<SampleType>& input, const juce::dsp::AudioBlock<SampleType>* bands) noexcept
+    {
+        const auto numChannels = juce::jmin (input.getNumChannels(), (size_t) maxChannels);
+        const auto numSamples = input.getNumSamples();
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            std::array<SampleType*, numBands> out;
+            for (size_t b = 0; b < numBands; ++b)
+                out[b] = bands[b].getChannelPointer (ch);
+
+            processChannel<slope> (ch, input.getChannelPointer (ch), out, numSamples);
+        }
+    }
+
+    // Un seul canal, avec l'état du canal ch
+    template <CrossoverSlope slope>
+    void processChannel (size_t ch, const SampleType* input, const std::array<SampleType*, numBands>& bands, size_t numSamples) noexcept
+    {
+        auto& state = channels[ch];
+
+        for (size_t i = 0; i < numSamples; ++i)
+            processNode<slope, 0, numBands> (state, input[i], bands, i);
+    }
+
+    // Passe-tout égal à la somme des bandes (chaque point de séparation une fois),
+    // sur place : ce qu'il faut à un canal qui n'a pas besoin d'être séparé pour
+    // rester en phase avec ceux qui le sont. En LR4, 1 SVF par point au lieu de 3.
+    template <CrossoverSlope slope>
+    void processAllpass (size_t ch, SampleType* data, size_t numSamples) noexcept
+    {
+        auto& allpasses = channels[ch].sumAllpass;
+
+        for (size_t i = 0; i < numSamples; ++i)
+            data[i] = compensate<slope, 0, numCrossovers> (allpasses, data[i]);
+    }
+
+private:
+    using FrequencySmoother = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>;
+
+    double sampleRate = 44100.0;
+    std::array<FrequencySmoother, numCrossovers> smoothers;
+    using Coefficients = LinkwitzRileyCoefficients<SampleType>;
+    using SplitState = LinkwitzRileySplitState<SampleType>;
+    using AllpassState = LinkwitzRileyAllpassState<SampleType>;
+
+    std::array<Coefficients, numCrossovers> coefficients;
+
+    // Le point de séparation k est la coupure d'un seul nœud : ses passe-tout de
+    // compensation sont rangés à l'indice k (au plus numBands - 2 par branche)
+    struct ChannelState
+    {
+        std::array<SplitState, numCrossovers> splits {};
+        std::array<std::array<AllpassState, numBands>, numCrossovers> lowCompensation {};
+        std::array<std::array<AllpassState, numBands>, numCrossovers> highCompensation {};
+        std::array<AllpassState, numBands> sumAllpass {};
+    };
+    std::array<ChannelState, maxChannels> channels {};
+
+    // Croissantes au sens large : getCrossoverFrequencies peut en rendre deux égales
+    static bool areValidFrequencies (const float* frequencies) noexcept
+    {
+        for (size_t i = 0; i < numCrossovers; ++i)
+            if (frequencies[i] <= 0.0f || (i > 0 && frequencies[i] < frequencies[i - 1]))
+                return false;
+
+        return true;
+    }
+
+    void updateCoefficients() noexcept
+    {
+        for (size_t i = 0; i < numCrossovers; ++i)
+            coefficients[i] = Coefficients::make (sampleRate, smoothers[i].getCurrentValue());
+    }
+
+    // Passe-tout des points de séparation [first, last) dans l'ordre
+    template <CrossoverSlope slope, size_t first, size_t last>
+    inline SampleType compensate (std::array<AllpassState, numBands>& allpasses, SampleType x) noexcept
+    {
+        if constexpr (first < last)
+        {
+            x = allpasses[first].template process<slope> (x, coefficients[first]);
+            return compensate<slope, first + 1, last> (allpasses, x);
+        }
+        else
+        {
+            return x;
+        }
+    }
+
+    // Nœud couvrant les bandes [lo, hi)
+    template <CrossoverSlope slope, size_t lo, size_t hi>
+    inline void processNode (ChannelState& state, SampleType x, const std::array<SampleType*, numBands>& out, size_t i) noexcept
+    {
+        if constexpr (hi - lo == 1)
+        {
+            out[lo][i] = x;
+        }
+        else
+        {
+            constexpr size_t split = lo + (hi - lo) / 2 - 1;
+
+            SampleType low, high;
+            state.splits[split].template process<slope> (x, coefficients[split], low, high);
+
+            // À gauche, les points de séparation de droite ; à droite, ceux de gauche
+            low = compensate<slope, split + 1, hi - 1> (state.lowCompensation[split], low);
+            high = compensate<slope, lo, split> (state.highCompensation[split], high);
+
+            processNode<slope, lo, split + 1> (state, low, out, i);
+            processNode<slope, split + 1, hi> (state, high, out, i);
+        }
+    }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include "BandSplitter.h"
+
+// Buffers de travail des bandes, alloués hors du thread audio (prepareToPlay)
+// puis réutilisés à chaque processBlock. Les canaux sont alignés SIMD.
+// Dimensionné pour le plus grand nombre de bandes : en changer ne réalloue rien.
+template <typename SampleType>
+class BandWorkspace
+{
+public:
+    static constexpr int maxBands = BandCount::max;
+
+    using Block = juce::dsp::AudioBlock<SampleType>;
+
+    // Ne réalloue que si le nombre de canaux ou la taille de bloc augmente
+    void prepare (int numChannelsToUse, int maxBlockSize)
+    {
+        if (numChannelsToUse > numChannels || maxBlockSize > maxSamples)
+        {
+            numChannels = juce::jmax (numChannels, numChannelsToUse);
+            maxSamples = juce::jmax (maxSamples, maxBlockSize);
+
+            for (size_t b = 0; b < maxBands; ++b)
+                bands[b] = Block (storage[b], (size_t) numChannels, (size_t) maxSamples);
+        }
+
+        for (auto& band : bands)
+            band.clear();
+    }
+
+    int getMaxBlockSize() const noexcept { return maxSamples; }
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // Vue sur une bande, limitée au bloc courant (aucune allocation)
+    Block getBand (int band, int numChannelsToUse, int numSamples) const noexcept
+    {
+        jassert (numChannelsToUse <= numChannels && numSamples <= maxSamples);
+        return bands[(size_t) band]
+            .getSubsetChannelBlock (0, (size_t) numChannelsToUse)
+            .getSubBlock (0, (size_t) numSamples);
+    }
+
+private:
+    std::array<juce::HeapBlock<char>, maxBands> storage;
+    std::array<Block, maxBands> bands;
+    int numChannels = 0;
+    int maxSamples = 0;
+};
@@ -0,0 +1,53 @@
+#include "CrossoverEngine.h"
+
+template <typename SampleType>
+void CrossoverEngine<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    forEachSplitter ([this] (auto& splitter) {
+        splitter.prepare (sampleRate, targetFrequencies.data(), smoothingTimeSeconds);
+    });
+
+    isPrepared = true;
+}
+
+template <typename SampleType>
+void CrossoverEngine<SampleType>::reset()
+{
+    forEachSplitter ([] (auto& splitter) { splitter.reset(); });
+}
+
+template <typename SampleType>
+void CrossoverEngine<SampleType>::setNumBands (int newNumBands) noexcept
+{
+    newNumBands = juce::jlimit (BandCount::min, BandCount::max, newNumBands);
+    if (newNumBands == numBands)
+        return;
+
+    numBands = newNumBands;
+
+    // La version inactive a reçu les cibles sans avancer ses glissements
+    BandCount::dispatch (numBands, [this] (auto n) {
+        auto& splitter = std::get<Splitter<decltype (n)::value>> (splitters);
+        splitter.snapToTargets();
+        splitter.reset();
+    });
+}
+
+template <typename SampleType>
+void CrossoverEngine<SampleType>::setCrossoverFrequencies (const std::array<float, maxCrossovers>& newFrequencies)
+{
+    // setTargetValue ne fait rien si la valeur n'a pas changé
+    targetFrequencies = newFrequencies;
+    forEachSplitter ([this] (auto& splitter) { splitter.setTargetFrequencies (targetFrequencies.data()); });
+}
+
+template <typename SampleType>
+void CrossoverEngine<SampleType>::process (const Block& input, const BandBlocks& bands)
+{
+    BandCount::dispatch (numBands, [&] (auto n) { this->template process<decltype (n)::value> (input, bands.data()); });
+}
+
+template class CrossoverEngine<float>;
+template class CrossoverEngine<double>;
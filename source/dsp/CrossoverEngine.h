@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <tuple>
+#include <juce_dsp/juce_dsp.h>
+#include "BandSplitter.h"
+
+// Séparation du signal en 2 à 8 bandes, sans aucune dépendance GUI.
+// Possédé par le processeur ; MultibandWidget ne fait que l'afficher et l'éditer.
+//
+// Une version de BandSplitter est compilée pour chaque nombre de bandes ; le
+// nombre choisi à l'exécution ne fait qu'aiguiller vers la bonne. Seule la
+// version active est traitée : 2 bandes ne coûtent que 1 filtre par échantillon.
+//
+// Instancié pour float et double (voir CrossoverEngine.cpp), selon la précision
+// demandée par l'hôte.
+template <typename SampleType>
+class CrossoverEngine
+{
+public:
+    static constexpr int maxBands = BandCount::max;
+    static constexpr int maxCrossovers = BandCount::maxCrossovers;
+
+    using Block = juce::dsp::AudioBlock<SampleType>;
+    using BandBlocks = std::array<Block, maxBands>;
+
+    // Prépare les filtres (à appeler avant process)
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Thread audio : sans allocation. La nouvelle version repart d'un état vide,
+    // directement aux fréquences cibles.
+    void setNumBands (int newNumBands) noexcept;
+    int getNumBands() const noexcept { return numBands; }
+
+    // Traite l'input en getNumBands() bandes (les blocs de sortie sont fournis déjà alloués)
+    void process (const Block& input, const BandBlocks& bands);
+
+    // Même chose avec un nombre de bandes connu à la compilation (doit valoir getNumBands())
+    template <size_t numBandsToUse>
+    void process (const Block& input, const Block* bands);
+
+    // Séparation du side seul : midSide contient le mid (canal 0) et le side (canal 1).
+    // Seul le canal 1 des bandes est écrit ; le mid est remplacé sur place par le
+    // passe-tout équivalent à la somme de ses bandes, pour rester en phase avec
+    // le side. Environ deux fois moins de filtres que process.
+    template <size_t numBandsToUse>
+    void processSideOnly (const Block& midSide, const Block* bands);
+
+    // Thread audio : nouvelles cibles, atteintes progressivement pendant process().
+    // Les coefficients ne sont recalculés que pendant un glissement, par sous-blocs.
+    // Seules les numBands - 1 premières fréquences servent.
+    void setCrossoverFrequencies (const std::array<float, maxCrossovers>& newFrequencies);
+    std::array<float, maxCrossovers> getCrossoverFrequencies() const { return targetFrequencies; }
+
+    static constexpr double smoothingTimeSeconds = 0.05;
+    static constexpr size_t smoothingSubBlockSize = 32;
+
+    // Changer de pente remet l'état des filtres à zéro
+    void setSlope (CrossoverSlope newSlope) { slope.store (newSlope); }
+    CrossoverSlope getSlope() const { return slope.load(); }
+
+private:
+    double sampleRate = 44100.0;
+    bool isPrepared = false;
+    int numBands = 4;
+
+    std::array<float, maxCrossovers> targetFrequencies { 200.f, 1000.f, 5000.f, 8000.f, 11000.f, 14000.f, 17000.f };
+
+    std::atomic<CrossoverSlope> slope { CrossoverSlope::lr4 };
+    CrossoverSlope currentSlope = CrossoverSlope::lr4;
+
+    template <size_t numBandsToUse>
+    using Splitter = BandSplitter<numBandsToUse, SampleType>;
+
+    std::tuple<Splitter<2>, Splitter<3>, Splitter<4>, Splitter<5>, Splitter<6>, Splitter<7>, Splitter<8>> splitters;
+
+    // Gère le changement de pente et le découpage en sous-blocs pendant un
+    // glissement ; processSubBlock (slope, splitter, start, length) reçoit la
+    // pente comme constante de compilation
+    template <size_t numBandsToUse, typename Function>
+    void processInSubBlocks (size_t numSamples, Function&& processSubBlock);
+
+    template <typename Function>
+    void forEachSplitter (Function&& fn)
+    {
+        std::apply ([&fn] (auto&... splitter) { (fn (splitter), ...); }, splitters);
+    }
+};
+
+template <typename SampleType>
+template <size_t numBandsToUse>
+void CrossoverEngine<SampleType>::process (const Block& input, const Block* bands)
+{
+    processInSubBlocks<numBandsToUse> (input.getNumSamples(), [&] (auto slope, auto& splitter, size_t start, size_t length) {
+        const auto in = input.getSubBlock (start, length);
+
+        std::array<Block, numBandsToUse> out;
+        for (size_t b = 0; b < numBandsToUse; ++b)
+            out[b] = bands[b].getSubBlock (start, length);
+
+        splitter.template process<decltype (slope)::value> (in, out.data());
+    });
+}
+
+template <typename SampleType>
+template <size_t numBandsToUse>
+void CrossoverEngine<SampleType>::processSideOnly (const Block& midSide, const Block* bands)
+{
+    jassert (midSide.getNumChannels() >= 2);
+
+    processInSubBlocks<numBandsToUse> (midSide.getNumSamples(), [&] (auto slope, auto& splitter, size_t start, size_t length) {
+        constexpr auto s = decltype (slope)::value;
+
+        std::array<SampleType*, numBandsToUse> out;
+        for (size_t b = 0; b < numBandsToUse; ++b)
+            out[b] = bands[b].getChannelPointer (1) + start;
+
+        splitter.template processChannel<s> (1, midSide.getChannelPointer (1) + start, out, length);
+        splitter.template processAllpass<s> (0, midSide.getChannelPointer (0) + start, length);
+    });
+}
+
+template <typename SampleType>
+template <size_t numBandsToUse, typename Function>
+void CrossoverEngine<SampleType>::processInSubBlocks (size_t numSamples, Function&& processSubBlock)
+{
+    jassert (isPrepared);
+    jassert ((int) numBandsToUse == numBands);
+
+    if (const auto newSlope = slope.load(); newSlope != currentSlope)
+    {
+        currentSlope = newSlope;
+        reset();
+    }
+
+    auto& splitter = std::get<Splitter<numBandsToUse>> (splitters);
+
+    for (size_t start = 0; start < numSamples;)
+    {
+        // Hors glissement, tout le bloc est traité d'un coup avec les mêmes coefficients
+        auto length = numSamples - start;
+        if (splitter.isSmoothing())
+        {
+            length = juce::jmin (length, smoothingSubBlockSize);
+            splitter.advanceSmoothing ((int) length);
+        }
+
+        switch (currentSlope)
+        {
+            case CrossoverSlope::lr2:
+                processSubBlock (std::integral_constant<CrossoverSlope, CrossoverSlope::lr2> {}, splitter, start, length);
+                break;
+            case CrossoverSlope::lr4:
+                processSubBlock (std::integral_constant<CrossoverSlope, CrossoverSlope::lr4> {}, splitter, start, length);
+                break;
+            case CrossoverSlope::lr8:
+                processSubBlock (std::integral_constant<CrossoverSlope, CrossoverSlope::lr8> {}, splitter, start, length);
+                break;
+        }
+
+        start += length;
+    }
+}
+
+extern template class CrossoverEngine<float>;
+extern template class CrossoverEngine<double>;
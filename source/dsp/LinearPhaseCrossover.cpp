@@ -0,0 +1,348 @@
+#include "LinearPhaseCrossover.h"
+#include <cmath>
+#include <numbers>
+
+LinearPhaseCrossover::LinearPhaseCrossover()
+    : juce::Thread ("SR23 FIR Kernels")
+{
+    const std::array<float, maxCrossovers> defaults { 200.0f, 1000.0f, 5000.0f, 8000.0f, 11000.0f, 14000.0f, 17000.0f };
+    for (size_t i = 0; i < maxCrossovers; ++i)
+        requestedFrequencies[i].store (defaults[i]);
+}
+
+LinearPhaseCrossover::~LinearPhaseCrossover()
+{
+    stopThread (2000);
+}
+
+void LinearPhaseCrossover::allocate()
+{
+    if (fft != nullptr)
+        return;
+
+    fft = std::make_unique<juce::dsp::FFT> (fftOrder);
+    designFft = std::make_unique<juce::dsp::FFT> (fftOrder);
+    fftBuffer.assign ((size_t) fftSize * 2, 0.0f);
+    accumulator.assign ((size_t) numBins, {});
+    crossfadeBuffer.assign ((size_t) partitionSize, 0.0f);
+    designBuffer.assign ((size_t) fftSize * 2, 0.0f);
+    window.resize ((size_t) kernelLength);
+    bandTaps.assign ((size_t) (partitionSize * numPartitions), 0.0f);
+
+    // Blackman-Harris : atténuation d'environ 92 dB hors de la bande de transition
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) kernelLength, juce::dsp::WindowingFunction<float>::blackmanHarris, false);
+
+    for (auto& lowPass : lowPasses)
+        lowPass.resize ((size_t) kernelLength);
+
+    for (auto& kernels : kernelStorage)
+        for (auto& partitions : kernels.partitions)
+            partitions.resize ((size_t) (numPartitions * numBins));
+}
+
+void LinearPhaseCrossover::prepare (double newSampleRate, int numChannels)
+{
+    stopThread (2000);
+    prepared.store (false);
+
+    sampleRate = newSampleRate;
+    allocate();
+
+    channels.resize ((size_t) numChannels);
+    for (auto& channel : channels)
+    {
+        channel.input.assign ((size_t) partitionSize, 0.0f);
+        channel.previousInput.assign ((size_t) partitionSize, 0.0f);
+        for (auto& output : channel.output)
+            output.assign ((size_t) partitionSize, 0.0f);
+        channel.history.assign ((size_t) (numPartitions * numBins), {});
+    }
+
+    // Le premier noyau est calculé tout de suite : pas de fondu au démarrage
+    designedFrequencies = loadRequestedFrequencies();
+    designedNumBands = requestedNumBands.load();
+    designKernels (kernelStorage[0], designedFrequencies, designedNumBands);
+    numOutputBands = designedNumBands;
+    active = &kernelStorage[0];
+    previous = nullptr;
+    building = &kernelStorage[1];
+    returnBox.store (&kernelStorage[2]);
+    mailbox.store (nullptr);
+
+    reset();
+    prepared.store (true, std::memory_order_release);
+    startThread (juce::Thread::Priority::low);
+}
+
+void LinearPhaseCrossover::reset() noexcept
+{
+    for (auto& channel : channels)
+    {
+        std::fill (channel.input.begin(), channel.input.end(), 0.0f);
+        std::fill (channel.previousInput.begin(), channel.previousInput.end(), 0.0f);
+        for (auto& output : channel.output)
+            std::fill (output.begin(), output.end(), 0.0f);
+        std::fill (channel.history.begin(), channel.history.end(), std::complex<float> {});
+    }
+
+    position = 0;
+    historyPosition = 0;
+}
+
+void LinearPhaseCrossover::setCrossoverFrequencies (const std::array<float, maxCrossovers>& newFrequencies) noexcept
+{
+    bool changed = false;
+    for (size_t i = 0; i < maxCrossovers; ++i)
+        changed |= requestedFrequencies[i].exchange (newFrequencies[i], std::memory_order_relaxed) != newFrequencies[i];
+
+    if (changed)
+        notify();
+}
+
+void LinearPhaseCrossover::setNumBands (int newNumBands) noexcept
+{
+    const auto clamped = juce::jlimit (BandCount::min, BandCount::max, newNumBands);
+    if (requestedNumBands.exchange (clamped, std::memory_order_relaxed) != clamped)
+        notify();
+}
+
+std::array<float, LinearPhaseCrossover::maxCrossovers> LinearPhaseCrossover::loadRequestedFrequencies() const noexcept
+{
+    std::array<float, maxCrossovers> frequencies;
+    for (size_t i = 0; i < maxCrossovers; ++i)
+        frequencies[i] = requestedFrequencies[i].load (std::memory_order_relaxed);
+
+    return frequencies;
+}
+
+//==============================================================================
+void LinearPhaseCrossover::run()
+{
+    while (! threadShouldExit())
+    {
+        const auto target = loadRequestedFrequencies();
+        const auto targetNumBands = requestedNumBands.load (std::memory_order_relaxed);
+
+        // Le jeu libéré par le thread audio n'est récupéré qu'après son fondu
+        if (building == nullptr)
+            building = returnBox.exchange (nullptr);
+
+        bool pending = target != designedFrequencies || targetNumBands != designedNumBands;
+
+        if (pending && building != nullptr)
+        {
+            designKernels (*building, target, targetNumBands);
+            designedFrequencies = target;
+            designedNumBands = targetNumBands;
+            pending = false;
+
+            // Si le thread audio n'avait pas encore pris le précédent, on le réutilise
+            building = mailbox.exchange (building);
+            if (building == nullptr)
+                building = returnBox.exchange (nullptr);
+        }
+
+        // Endormi jusqu'au prochain changement (notify). Sans jeu libre, le fondu
+        // en cours côté audio le rendra au plus tard un bloc plus tard.
+        wait (pending ? 5 : -1);
+    }
+}
+
+void LinearPhaseCrossover::designKernels (KernelSet& destination, const std::array<float, maxCrossovers>& frequencies, int numBands)
+{
+    const int centre = (kernelLength - 1) / 2;
+    const auto numCrossovers = (size_t) (numBands - 1);
+    destination.numBands = numBands;
+
+    // Passe-bas en sinus cardinal fenêtré, normalisés pour un gain continu unitaire
+    for (size_t k = 0; k < numCrossovers; ++k)
+    {
+        const auto cutoff = (double) juce::jlimit (1.0f, (float) (0.49 * sampleRate), frequencies[k]) / sampleRate;
+        auto& lowPass = lowPasses[k];
+        double sum = 0.0;
+
+        for (int n = 0; n < kernelLength; ++n)
+        {
+            const auto t = (double) (n - centre);
+            const auto sinc = t == 0.0 ? 2.0 * cutoff : std::sin (2.0 * std::numbers::pi * cutoff * t) / (std::numbers::pi * t);
+            lowPass[(size_t) n] = (float) (sinc * window[(size_t) n]);
+            sum += lowPass[(size_t) n];
+        }
+
+        for (auto& tap : lowPass)
+            tap = (float) (tap / sum);
+    }
+
+    for (size_t band = 0; band < (size_t) numBands; ++band)
+    {
+        // bande = passe-bas (haut) - passe-bas (bas), avec 0 et une impulsion aux extrémités
+        for (int n = 0; n < kernelLength; ++n)
+        {
+            const auto upper = band < numCrossovers ? lowPasses[band][(size_t) n] : (n == centre ? 1.0f : 0.0f);
+            const auto lower = band > 0 ? lowPasses[band - 1][(size_t) n] : 0.0f;
+            bandTaps[(size_t) n] = upper - lower;
+        }
+
+        auto* spectra = destination.partitions[band].data();
+
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            std::fill (designBuffer.begin(), designBuffer.end(), 0.0f);
+            std::copy_n (bandTaps.begin() + p * partitionSize, partitionSize, designBuffer.begin());
+            designFft->performRealOnlyForwardTransform (designBuffer.data(), true);
+
+            std::copy_n (reinterpret_cast<const std::complex<float>*> (designBuffer.data()), numBins, spectra + p * numBins);
+        }
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void LinearPhaseCrossover::process (const juce::dsp::AudioBlock<SampleType>& input, const juce::dsp::AudioBlock<SampleType>* bands, int numBands) noexcept
+{
+    jassert (active != nullptr);
+    jassert (numBands >= BandCount::min && numBands <= BandCount::max);
+
+    const auto lastBand = (size_t) (numBands - 1);
+    const int numChannels = juce::jmin ((int) input.getNumChannels(), (int) channels.size());
+    const int numSamples = (int) input.getNumSamples();
+
+    // Les sorties d'un bloc sont celles calculées au bloc précédent (latence d'un bloc)
+    for (int done = 0; done < numSamples;)
+    {
+        const int chunk = juce::jmin (numSamples - done, partitionSize - position);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& channel = channels[(size_t) ch];
+            std::copy_n (input.getChannelPointer ((size_t) ch) + done, chunk, channel.input.begin() + position);
+
+            for (size_t band = 0; band <= lastBand; ++band)
+            {
+                auto* destination = bands[band].getChannelPointer ((size_t) ch) + done;
+
+                if (band < (size_t) numOutputBands)
+                    std::copy_n (channel.output[band].begin() + position, chunk, destination);
+                else
+                    std::fill_n (destination, chunk, SampleType (0));
+            }
+
+            for (size_t band = lastBand + 1; band < (size_t) numOutputBands; ++band)
+            {
+                auto* destination = bands[lastBand].getChannelPointer ((size_t) ch) + done;
+                const auto* source = channel.output[band].data() + position;
+
+                if constexpr (std::is_same_v<SampleType, float>)
+                    juce::FloatVectorOperations::add (destination, source, chunk);
+                else
+                    for (int i = 0; i < chunk; ++i)
+                        destination[i] += source[i];
+            }
+        }
+
+        position += chunk;
+        done += chunk;
+
+        if (position == partitionSize)
+        {
+            processPartition (numChannels);
+            position = 0;
+        }
+    }
+}
+
+template void LinearPhaseCrossover::process (const juce::dsp::AudioBlock<float>&, const juce::dsp::AudioBlock<float>*, int) noexcept;
+template void LinearPhaseCrossover::process (const juce::dsp::AudioBlock<double>&, const juce::dsp::AudioBlock<double>*, int) noexcept;
+
+void LinearPhaseCrossover::processPartition (int numChannels) noexcept
+{
+    // Nouveau noyau : on le prend à une frontière de bloc et on fond depuis l'ancien
+    if (auto* fresh = mailbox.exchange (nullptr))
+    {
+        previous = active;
+        active = fresh;
+    }
+
+    historyPosition = (historyPosition + 1) % numPartitions;
+
+    // Pendant un fondu entre deux nombres de bandes, une bande absente d'un noyau est nulle
+    numOutputBands = juce::jmax (active->numBands, previous != nullptr ? previous->numBands : 0);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& channel = channels[(size_t) ch];
+
+        // Overlap-save : bloc précédent + bloc courant, une seule FFT directe
+        std::copy (channel.previousInput.begin(), channel.previousInput.end(), fftBuffer.begin());
+        std::copy (channel.input.begin(), channel.input.end(), fftBuffer.begin() + partitionSize);
+        std::fill (fftBuffer.begin() + fftSize, fftBuffer.end(), 0.0f);
+        fft->performRealOnlyForwardTransform (fftBuffer.data(), true);
+
+        std::copy_n (reinterpret_cast<const std::complex<float>*> (fftBuffer.data()), numBins, channel.history.begin() + historyPosition * numBins);
+        std::copy (channel.input.begin(), channel.input.end(), channel.previousInput.begin());
+
+        for (size_t band = 0; band < (size_t) numOutputBands; ++band)
+        {
+            auto* output = channel.output[band].data();
+
+            if (band < (size_t) active->numBands)
+                convolve (channel, *active, band, output);
+            else
+                std::fill_n (output, partitionSize, 0.0f);
+
+            if (previous != nullptr)
+            {
+                if (band < (size_t) previous->numBands)
+                    convolve (channel, *previous, band, crossfadeBuffer.data());
+                else
+                    std::fill (crossfadeBuffer.begin(), crossfadeBuffer.end(), 0.0f);
+
+                for (int i = 0; i < partitionSize; ++i)
+                {
+                    const auto gain = (float) (i + 1) / (float) partitionSize;
+                    output[i] = crossfadeBuffer[(size_t) i] + gain * (output[i] - crossfadeBuffer[(size_t) i]);
+                }
+            }
+        }
+    }
+
+    // Fin du fondu : l'ancien jeu retourne au thread de calcul
+    if (previous != nullptr)
+    {
+        jassert (returnBox.load() == nullptr);
+        returnBox.store (previous);
+        previous = nullptr;
+    }
+}
+
+void LinearPhaseCrossover::convolve (const ChannelState& channel, const KernelSet& kernels, size_t band, float* destination) noexcept
+{
+    std::fill (accumulator.begin(), accumulator.end(), std::complex<float> {});
+
+    // Produit complexe écrit à la main : l'opérateur de std::complex gère les
+    // infinis et NaN et empêche la vectorisation
+    auto* acc = reinterpret_cast<float*> (accumulator.data());
+    const auto* kernel = reinterpret_cast<const float*> (kernels.partitions[band].data());
+    const auto* history = reinterpret_cast<const float*> (channel.history.data());
+
+    // La partition p du noyau s'applique au spectre d'entrée d'il y a p blocs
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        const auto slot = (historyPosition - p + numPartitions) % numPartitions;
+        const auto* x = history + 2 * slot * numBins;
+        const auto* h = kernel + 2 * p * numBins;
+
+        for (int k = 0; k < 2 * numBins; k += 2)
+        {
+            acc[k] += x[k] * h[k] - x[k + 1] * h[k + 1];
+            acc[k + 1] += x[k] * h[k + 1] + x[k + 1] * h[k];
+        }
+    }
+
+    std::copy (accumulator.begin(), accumulator.end(), reinterpret_cast<std::complex<float>*> (fftBuffer.data()));
+    std::fill (fftBuffer.begin() + 2 * numBins, fftBuffer.end(), 0.0f);
+    fft->performRealOnlyInverseTransform (fftBuffer.data());
+
+    // Seule la seconde moitié est une convolution linéaire valide
+    std::copy_n (fftBuffer.begin() + partitionSize, partitionSize, destination);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <complex>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+#include "BandSplitter.h"
+
+// Séparation en 2 à 8 bandes à phase linéaire, pour le mastering.
+// Chaque bande est un FIR symétrique : différence de deux passe-bas en sinus
+// cardinal fenêtrés (le premier et le dernier utilisent 0 et une impulsion), si
+// bien que la somme des bandes est une impulsion retardée.
+//
+// Convolution partitionnée uniforme (overlap-save) : l'entrée est découpée en
+// blocs de partitionSize, une seule FFT directe par bloc et par canal alimente
+// toutes les bandes, qui ne coûtent qu'une accumulation spectrale et une FFT
+// inverse chacune : le coût suit le nombre de bandes choisi.
+//
+// Les noyaux sont recalculés sur un thread d'arrière-plan, réveillé seulement quand
+// les fréquences ou le nombre de bandes changent, puis échangés sans verrou ; le premier bloc traité avec un nouveau
+// noyau est un fondu entre l'ancien et le nouveau.
+//
+// Rien n'est alloué ni lancé avant le premier prepare : une instance qui reste sur
+// le crossover IIR ne paie ni les noyaux (environ 1,6 Mo) ni le thread.
+class LinearPhaseCrossover : private juce::Thread
+{
+public:
+    static constexpr int maxBands = BandCount::max;
+    static constexpr int maxCrossovers = maxBands - 1;
+    static constexpr int partitionSize = 512;
+    static constexpr int numPartitions = 16;
+    static constexpr int kernelLength = partitionSize * numPartitions - 1;
+
+    LinearPhaseCrossover();
+    ~LinearPhaseCrossover() override;
+
+    // Thread message, sans process en cours : alloue, calcule le premier noyau et lance le thread
+    void prepare (double newSampleRate, int numChannels);
+
+    // Vrai une fois prepare terminé : process, reset et getLatencySamples n'ont de sens qu'après
+    bool isPrepared() const noexcept { return prepared.load (std::memory_order_acquire); }
+
+    // Thread audio : vide les buffers sans toucher aux noyaux
+    void reset() noexcept;
+
+    // Thread audio : les noyaux suivront dès que le thread d'arrière-plan les aura calculés.
+    // Seules les numBands - 1 premières fréquences servent. Le thread n'est réveillé
+    // que si une valeur change.
+    void setCrossoverFrequencies (const std::array<float, maxCrossovers>& newFrequencies) noexcept;
+    void setNumBands (int newNumBands) noexcept;
+
+    // Remplit numBands blocs. Tant que le noyau n'a pas rattrapé un changement du
+    // nombre de bandes, les bandes en trop sont ajoutées à la dernière et celles qui
+    // manquent sont silencieuses : la somme reste une impulsion retardée.
+    // En double précision, seules l'entrée et la sortie sont converties : les
+    // noyaux et la convolution restent en float (juce::dsp::FFT).
+    template <typename SampleType>
+    void process (const juce::dsp::AudioBlock<SampleType>& input, const juce::dsp::AudioBlock<SampleType>* bands, int numBands) noexcept;
+
+    // Mise en tampon d'un bloc plus la moitié du noyau
+    static constexpr int getLatencySamples() noexcept { return partitionSize + (kernelLength - 1) / 2; }
+
+private:
+    using Spectrum = std::vector<std::complex<float>>;
+
+    static constexpr int fftOrder = 10;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2 + 1;
+    static_assert (fftSize == 2 * partitionSize);
+
+    // Spectres des partitions de chaque bande, numPartitions * numBins valeurs par bande
+    struct KernelSet
+    {
+        int numBands = 0;
+        std::array<Spectrum, maxBands> partitions;
+    };
+
+    struct ChannelState
+    {
+        std::vector<float> input, previousInput;
+        std::array<std::vector<float>, maxBands> output;
+        Spectrum history; // numPartitions spectres d'entrée, en anneau
+    };
+
+    double sampleRate = 44100.0;
+    std::atomic<bool> prepared { false };
+    std::array<std::atomic<float>, maxCrossovers> requestedFrequencies;
+    std::atomic<int> requestedNumBands { 4 };
+
+    // Thread audio
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> fftBuffer;
+    Spectrum accumulator;
+    std::vector<float> crossfadeBuffer;
+    std::vector<ChannelState> channels;
+    int position = 0;
+    int historyPosition = 0;
+    int numOutputBands = 0; // bandes calculées dans output (les suivantes sont à ignorer)
+
+    // Trois jeux de noyaux qui circulent entre les threads. Le thread audio possède
+    // active (et previous le temps du fondu) ; le thread de calcul possède building ;
+    // les deux autres transitent par mailbox (prêt) et returnBox (libéré).
+    std::array<KernelSet, 3> kernelStorage;
+    KernelSet* active = nullptr;
+    KernelSet* previous = nullptr;
+    KernelSet* building = nullptr;
+    std::atomic<KernelSet*> mailbox { nullptr };
+    std::atomic<KernelSet*> returnBox { nullptr };
+
+    // Thread de calcul des noyaux
+    std::array<float, maxCrossovers> designedFrequencies {};
+    int designedNumBands = 0;
+    std::unique_ptr<juce::dsp::FFT> designFft;
+    std::vector<float> designBuffer;
+    std::vector<float> window;
+    std::array<std::vector<float>, maxCrossovers> lowPasses;
+    std::vector<float> bandTaps;
+
+    void allocate();
+    void run() override;
+    void designKernels (KernelSet& destination, const std::array<float, maxCrossovers>& frequencies, int numBands);
+    std::array<float, maxCrossovers> loadRequestedFrequencies() const noexcept;
+
+    void processPartition (int numChannels) noexcept;
+    void convolve (const ChannelState& channel, const KernelSet& kernels, size_t band, float* destination) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhaseCrossover)
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <numbers>
+
+// Pente des filtres de séparation Linkwitz-Riley
+enum class CrossoverSlope
+{
+    lr2, // 12 dB/oct
+    lr4, // 24 dB/oct
+    lr8  // 48 dB/oct
+};
+
+//==============================================================================
+// SVF en topologie TPT (Zavalishin / Cytomic) : passe-bas, passe-bande et
+// passe-haut sont obtenus en même temps, sans déformation près de Nyquist.
+// Contrairement à une biquad en forme directe, ses états restent bien
+// conditionnés pour des coupures très basses devant la fréquence
+// d'échantillonnage, en float comme en double.
+//
+// Tout est paramétré par le type d'échantillon ; les coefficients sont
+// calculés en double puis arrondis.
+template <typename SampleType>
+struct SvfCoefficients
+{
+    SampleType k = 2, a1 = 0, a2 = 0, a3 = 0;
+
+    static SvfCoefficients make (double sampleRate, double frequency, double k)
+    {
+        const auto g = std::tan (std::numbers::pi * frequency / sampleRate);
+        const auto a1 = 1.0 / (1.0 + g * (g + k));
+
+        SvfCoefficients c;
+        c.k = (SampleType) k;
+        c.a1 = (SampleType) a1;
+        c.a2 = (SampleType) (g * a1);
+        c.a3 = (SampleType) (g * g * a1);
+        return c;
+    }
+};
+
+template <typename SampleType>
+struct SvfState
+{
+    using Coefficients = SvfCoefficients<SampleType>;
+
+    SampleType ic1eq = 0, ic2eq = 0;
+
+    // Renvoie la sortie passe-bande (band) et passe-bas (low)
+    inline void tick (SampleType v0, const Coefficients& c, SampleType& band, SampleType& low) noexcept
+    {
+        const auto v3 = v0 - ic2eq;
+        band = c.a1 * ic1eq + c.a2 * v3;
+        low = ic2eq + c.a2 * ic1eq + c.a3 * v3;
+        ic1eq = 2 * band - ic1eq;
+        ic2eq = 2 * low - ic2eq;
+    }
+
+    inline SampleType lowPass (SampleType x, const Coefficients& c) noexcept
+    {
+        SampleType band, low;
+        tick (x, c, band, low);
+        return low;
+    }
+
+    inline SampleType highPass (SampleType x, const Coefficients& c) noexcept
+    {
+        SampleType band, low;
+        tick (x, c, band, low);
+        return x - c.k * band - low;
+    }
+
+    inline SampleType allPass (SampleType x, const Coefficients& c) noexcept
+    {
+        SampleType band, low;
+        tick (x, c, band, low);
+        return x - 2 * c.k * band;
+    }
+};
+
+// Filtre du premier ordre TPT (utilisé pour LR2)
+template <typename SampleType>
+struct OnePoleState
+{
+    SampleType s = 0;
+
+    inline SampleType lowPass (SampleType x, SampleType G) noexcept
+    {
+        const auto v = (x - s) * G;
+        const auto low = v + s;
+        s = low + v;
+        return low;
+    }
+};
+
+//==============================================================================
+// Coefficients d'un point de séparation. Un LR d'ordre 2n est un Butterworth
+// d'ordre n appliqué deux fois ; la somme passe-bas + passe-haut est alors le
+// passe-tout de ce Butterworth, ce qui sert à compenser la phase des autres bandes.
+template <typename SampleType>
+struct LinkwitzRileyCoefficients
+{
+    using Svf = SvfCoefficients<SampleType>;
+
+    SampleType G = 0; // LR2 : filtre du premier ordre
+    Svf bw2;          // LR4 : Butterworth d'ordre 2
+    Svf bw4a;         // LR8 : les deux sections du Butterworth d'ordre 4
+    Svf bw4b;
+
+    static LinkwitzRileyCoefficients make (double sampleRate, double frequency)
+    {
+        const auto g = std::tan (std::numbers::pi * frequency / sampleRate);
+
+        // Facteurs d'amortissement (k = 1/Q) des sections Butterworth
+        LinkwitzRileyCoefficients c;
+        c.G = (SampleType) (g / (1.0 + g));
+        c.bw2 = Svf::make (sampleRate, frequency, std::numbers::sqrt2);
+        c.bw4a = Svf::make (sampleRate, frequency, 1.8477590650225735);
+        c.bw4b = Svf::make (sampleRate, frequency, 0.7653668647301796);
+        return c;
+    }
+};
+
+// Sépare un canal en passe-bas / passe-haut complémentaires.
+// En LR2 la sortie passe-haut est inversée pour que la somme reste plate.
+template <typename SampleType>
+struct LinkwitzRileySplitState
+{
+    std::array<OnePoleState<SampleType>, 3> onePole {};
+    std::array<SvfState<SampleType>, 7> svf {};
+
+    void reset() noexcept { *this = {}; }
+
+    template <CrossoverSlope slope>
+    inline void process (SampleType x, const LinkwitzRileyCoefficients<SampleType>& c, SampleType& low, SampleType& high) noexcept
+    {
+        if constexpr (slope == CrossoverSlope::lr2)
+        {
+            const auto lp = onePole[0].lowPass (x, c.G);
+            const auto hp = x - lp;
+            low = onePole[1].lowPass (lp, c.G);
+            high = onePole[2].lowPass (hp, c.G) - hp;
+        }
+        else if constexpr (slope == CrossoverSlope::lr4)
+        {
+            SampleType band, lp;
+            svf[0].tick (x, c.bw2, band, lp);
+            const auto hp = x - c.bw2.k * band - lp;
+            low = svf[1].lowPass (lp, c.bw2);
+            high = svf[2].highPass (hp, c.bw2);
+        }
+        else
+        {
+            SampleType band, lp;
+            svf[0].tick (x, c.bw4a, band, lp);
+            const auto hp = x - c.bw4a.k * band - lp;
+            low = svf[3].lowPass (svf[2].lowPass (svf[1].lowPass (lp, c.bw4b), c.bw4a), c.bw4b);
+            high = svf[6].highPass (svf[5].highPass (svf[4].highPass (hp, c.bw4b), c.bw4a), c.bw4b);
+        }
+    }
+};
+
+// Passe-tout équivalent à la somme low + high d'un LinkwitzRileySplitState
+template <typename SampleType>
+struct LinkwitzRileyAllpassState
+{
+    OnePoleState<SampleType> onePole {};
+    std::array<SvfState<SampleType>, 2> svf {};
+
+    void reset() noexcept { *this = {}; }
+
+    template <CrossoverSlope slope>
+    inline SampleType process (SampleType x, const LinkwitzRileyCoefficients<SampleType>& c) noexcept
+    {
+        if constexpr (slope == CrossoverSlope::lr2)
+            return 2 * onePole.lowPass (x, c.G) - x;
+        else if constexpr (slope == CrossoverSlope::lr4)
+            return svf[0].allPass (x, c.bw2);
+        else
+            return svf[1].allPass (svf[0].allPass (x, c.bw4a), c.bw4b);
+    }
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include "LinkwitzRiley.h"
+
+// Basses mono : passe-haut raide (48 dB/oct, deux Butterworth d'ordre 4 en
+// cascade, soit le passe-haut d'un LR8) sur le side total, appliqué par
+// WidthKernel pendant la passe de largeur. Sous la coupure, L et R ne
+// contiennent plus que le mid, quelle que soit la largeur des bandes.
+//
+// Désactivé, le filtre glisse jusqu'à offFrequency puis n'est plus appelé :
+// activer et désactiver ne produit pas de saut audible.
+template <typename SampleType>
+class MonoBass
+{
+public:
+    // Interface attendue par WidthKernel pour filtrer le side
+    static constexpr bool isActive = true;
+
+    static constexpr float offFrequency = 5.0f;
+    static constexpr double smoothingTimeSeconds = 0.05;
+
+    // Garde le réglage en cours (setTarget peut être appelé avant prepare)
+    void prepare (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        frequency.reset (sampleRate, smoothingTimeSeconds);
+        frequency.setCurrentAndTargetValue (enabled ? targetFrequency : offFrequency);
+        bypassed = ! enabled;
+
+        coefficients = Coefficients::make (sampleRate, frequency.getCurrentValue());
+        reset();
+    }
+
+    void reset() noexcept { svf = {}; }
+
+    // Thread audio, une fois par bloc
+    void setTarget (bool shouldBeEnabled, float newFrequency) noexcept
+    {
+        targetFrequency = newFrequency;
+
+        // Repart d'un état vide, depuis une coupure qui ne retire presque rien
+        if (shouldBeEnabled && bypassed)
+        {
+            reset();
+            frequency.setCurrentAndTargetValue (offFrequency);
+            coefficients = Coefficients::make (sampleRate, offFrequency);
+            bypassed = false;
+        }
+
+        enabled = shouldBeEnabled;
+        frequency.setTargetValue (enabled ? targetFrequency : offFrequency);
+    }
+
+    // Vrai si le side peut passer sans filtre pour les numSamples suivants
+    bool isBypassed() const noexcept { return bypassed; }
+
+    // Avance le glissement de la coupure avant de traiter numSamples échantillons
+    void advance (int numSamples) noexcept
+    {
+        if (! frequency.isSmoothing())
+            return;
+
+        coefficients = Coefficients::make (sampleRate, frequency.skip (numSamples));
+
+        if (! enabled && ! frequency.isSmoothing())
+            bypassed = true;
+    }
+
+    inline SampleType process (SampleType side) noexcept
+    {
+        side = svf[0].highPass (side, coefficients.bw4a);
+        side = svf[1].highPass (side, coefficients.bw4b);
+        side = svf[2].highPass (side, coefficients.bw4a);
+        return svf[3].highPass (side, coefficients.bw4b);
+    }
+
+private:
+    double sampleRate = 44100.0;
+    bool enabled = false, bypassed = true;
+    float targetFrequency = 120.0f;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> frequency { offFrequency };
+    using Coefficients = LinkwitzRileyCoefficients<SampleType>;
+
+    Coefficients coefficients;
+    std::array<SvfState<SampleType>, 4> svf {};
+};
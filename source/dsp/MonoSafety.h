@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "BandSplitter.h"
+#include "WidthKernel.h"
+
+// Limiteur de compatibilité mono : plafonne la largeur de chaque bande pour que
+// sa corrélation courante ne descende pas sous un minimum. Comme StereoMeters,
+// il n'intègre que les sommes de la passe de largeur (WidthKernel) : aucune
+// passe supplémentaire sur les bandes.
+//
+// Avec M = somme mid² et D = somme side² avant largeur, la largeur w
+// donne un side S = w² D. En négligeant le terme de balance, la corrélation
+// vaut (M - S) / (M + S) ; elle reste au-dessus de c tant que
+//   w² <= M / D * (1 - c) / (1 + c)
+// Le terme de balance ne fait qu'éloigner la corrélation de zéro : pour c >= 0
+// le plafond est prudent.
+class MonoSafety
+{
+public:
+    static constexpr size_t maxBands = BandCount::max;
+    static constexpr double integrationTimeSeconds = 0.3;
+
+    // À -1, aucune largeur n'est plafonnée
+    static constexpr float offCorrelation = -1.0f;
+
+    MonoSafety() { reset(); }
+
+    void prepare (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        running = {};
+        limits.fill (noLimit);
+    }
+
+    // Thread audio : corrélation minimale de chaque bande, de -1 à +1
+    void setMinimumCorrelation (float newCorrelation) noexcept { minimumCorrelation = std::clamp (newCorrelation, -1.0f, 1.0f); }
+
+    // Thread audio, une fois par bloc, avec les sommes de la passe de largeur.
+    // Les plafonds servent au bloc suivant, lissés par WidthStage.
+    void update (const WidthKernel::BandSums<maxBands>& blockSums, int numSamples) noexcept
+    {
+        const auto decay = std::exp (-(double) numSamples / (integrationTimeSeconds * sampleRate));
+        const auto ratio = minimumCorrelation <= offCorrelation ? 0.0 : (1.0 - minimumCorrelation) / (1.0 + minimumCorrelation);
+
+        for (size_t b = 0; b < maxBands; ++b)
+        {
+            auto& sums = running[b];
+            sums.mid = sums.mid * decay + blockSums.mid[b];
+            sums.rawSide = sums.rawSide * decay + blockSums.rawSide[b];
+
+            constexpr double silence = 1.0e-12;
+            if (minimumCorrelation <= offCorrelation || sums.rawSide < silence)
+                limits[b] = noLimit;
+            else
+                limits[b] = (float) std::sqrt (ratio * sums.mid / sums.rawSide);
+        }
+    }
+
+    // Applique les plafonds aux largeurs demandées
+    void limit (std::array<float, maxBands>& widths) const noexcept
+    {
+        for (size_t b = 0; b < maxBands; ++b)
+            widths[b] = std::min (widths[b], limits[b]);
+    }
+
+    float getLimit (size_t band) const noexcept { return limits[band]; }
+
+private:
+    struct RunningSums
+    {
+        double mid = 0.0, rawSide = 0.0;
+    };
+
+    static constexpr float noLimit = std::numeric_limits<float>::max();
+
+    double sampleRate = 44100.0;
+    float minimumCorrelation = offCorrelation;
+    std::array<RunningSums, maxBands> running {};
+    std::array<float, maxBands> limits {};
+};
@@ -0,0 +1,36 @@
+#include "OversamplingStage.h"
+
+template <typename SampleType>
+void OversamplingStage<SampleType>::prepare (int numChannels, int maxBlockSize)
+{
+    for (size_t i = 0; i < oversamplers.size(); ++i)
+    {
+        // Latence entière pour pouvoir la déclarer exactement à l'hôte
+        oversamplers[i] = std::make_unique<juce::dsp::Oversampling<SampleType>> ((size_t) numChannels,
+            i + 1,
+            juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+            true,
+            true);
+        oversamplers[i]->initProcessing ((size_t) maxBlockSize);
+    }
+}
+
+template <typename SampleType>
+void OversamplingStage<SampleType>::reset() noexcept
+{
+    for (auto& oversampler : oversamplers)
+        if (oversampler != nullptr)
+            oversampler->reset();
+}
+
+template <typename SampleType>
+int OversamplingStage<SampleType>::getLatencySamples (Factor factor) const noexcept
+{
+    if (factor == Factor::x1 || oversamplers[(size_t) factor - 1] == nullptr)
+        return 0;
+
+    return juce::roundToInt (oversamplers[(size_t) factor - 1]->getLatencyInSamples());
+}
+
+template class OversamplingStage<float>;
+template class OversamplingStage<double>;
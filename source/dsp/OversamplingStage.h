@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+
+// Suréchantillonnage 2x / 4x autour du crossover et de la largeur, pour que le
+// dernier point de séparation (jusqu'à 20 kHz) ne soit pas déformé près de Nyquist.
+// Les deux suréchantillonneurs (demi-bande polyphase IIR) sont créés dans
+// prepare : changer de facteur sur le thread audio n'alloue rien.
+
+// Facteurs communs aux deux précisions
+struct OversamplingFactors
+{
+    // L'ordre suit les choix du paramètre OVERSAMPLING
+    enum class Factor
+    {
+        x1,
+        x2,
+        x4
+    };
+
+    static constexpr int maxFactor = 4;
+
+    static int toMultiplier (Factor factor) noexcept { return 1 << (int) factor; }
+};
+
+// Instancié pour float et double (voir OversamplingStage.cpp)
+template <typename SampleType>
+class OversamplingStage : public OversamplingFactors
+{
+public:
+    void prepare (int numChannels, int maxBlockSize);
+    void reset() noexcept;
+
+    // Latence ajoutée, en échantillons au taux de base
+    int getLatencySamples (Factor factor) const noexcept;
+
+    // Thread audio. En x1, process est appelé directement sur input.
+    template <typename ProcessFunction>
+    void process (Factor factor, juce::dsp::AudioBlock<SampleType>& input, ProcessFunction&& processOversampled)
+    {
+        if (factor == Factor::x1)
+        {
+            processOversampled (input);
+            return;
+        }
+
+        auto& oversampler = *oversamplers[(size_t) factor - 1];
+        processOversampled (oversampler.processSamplesUp (input));
+        oversampler.processSamplesDown (input);
+    }
+
+private:
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, 2> oversamplers;
+};
+
+extern template class OversamplingStage<float>;
+extern template class OversamplingStage<double>;
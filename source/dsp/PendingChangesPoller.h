@@ -0,0 +1,73 @@
+#pragma once
+
+#include <juce_events/juce_events.h>
+#include <vector>
+
+// Relève commune à toutes les instances du plugin chargées dans le processus :
+// un seul Timer du thread message appelle applyPendingChanges de chaque
+// processeur inscrit (latence à remonter à l'hôte, FIR à allouer), au lieu
+// d'un Timer par instance. Le Timer ne tourne que tant qu'un processeur est
+// inscrit ; le rendu hors ligne ne s'y inscrit pas.
+//
+// À partager via juce::SharedResourcePointer<PendingChangesPoller>, comme
+// l'AnalysisService. addClient et removeClient peuvent être appelés depuis
+// n'importe quel thread (prepareToPlay ne vient pas toujours du thread message).
+class PendingChangesPoller : private juce::Timer
+{
+public:
+    static constexpr int pollsPerSecond = 10;
+
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Thread message
+        virtual void applyPendingChanges() = 0;
+    };
+
+    PendingChangesPoller() = default;
+
+    ~PendingChangesPoller() override
+    {
+        // Les processeurs se désinscrivent avant de relâcher leur SharedResourcePointer
+        jassert (clients.empty());
+        stopTimer();
+    }
+
+    void addClient (Client& client)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (std::find (clients.begin(), clients.end(), &client) == clients.end())
+            clients.push_back (&client);
+
+        if (! isTimerRunning())
+            startTimerHz (pollsPerSecond);
+    }
+
+    // Attend la fin d'un éventuel applyPendingChanges en cours du client
+    void removeClient (Client& client)
+    {
+        const juce::ScopedLock sl (lock);
+
+        clients.erase (std::remove (clients.begin(), clients.end(), &client), clients.end());
+
+        if (clients.empty())
+            stopTimer();
+    }
+
+private:
+    juce::CriticalSection lock;
+    std::vector<Client*> clients;
+
+    void timerCallback() override
+    {
+        const juce::ScopedLock sl (lock);
+
+        for (auto* client : clients)
+            client->applyPendingChanges();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PendingChangesPoller)
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_core/juce_core.h>
+
+// Activé par défaut ; -DSR23_PERFORMANCE_MONITOR=0 (option CMake du même nom)
+// remplace toutes les méthodes par des fonctions vides, que le compilateur élimine.
+#ifndef SR23_PERFORMANCE_MONITOR
+    #define SR23_PERFORMANCE_MONITOR 1
+#endif
+
+// Mesure de la charge du thread audio en production : durée de chaque
+// processBlock rapportée au budget du bloc (numSamples / sampleRate), temps par
+// étape et histogramme des charges. Le thread audio n'écrit que des atomiques
+// (relaxed) ; le thread message lit un instantané quand il veut.
+class PerformanceMonitor
+{
+public:
+    enum class Stage
+    {
+        bandSplit,
+        width,
+        analysis,
+        numStages
+    };
+
+    static constexpr int numStages = (int) Stage::numStages;
+
+    // Tranches de 10 % du budget ; la dernière regroupe tout ce qui dépasse 150 %
+    static constexpr int numHistogramBins = 16;
+    static constexpr float histogramBinWidth = 0.1f;
+
+    // Lissage de la charge moyenne affichée (en blocs)
+    static constexpr float averagingBlocks = 64.0f;
+
+    struct Snapshot
+    {
+        float averageLoad = 0.0f; // fraction du budget, lissée
+        float peakLoad = 0.0f;    // depuis le dernier resetStatistics
+        std::array<float, numStages> stageLoads {};
+        std::array<juce::uint32, numHistogramBins> histogram {};
+        juce::uint64 numBlocks = 0;
+        juce::uint64 numOverruns = 0; // blocs qui ont dépassé leur budget
+    };
+
+    static constexpr bool isEnabled() noexcept { return SR23_PERFORMANCE_MONITOR != 0; }
+
+#if SR23_PERFORMANCE_MONITOR
+    void prepare (double newSampleRate) noexcept
+    {
+        ticksPerSample = (double) juce::Time::getHighResolutionTicksPerSecond() / newSampleRate;
+        resetStatistics();
+    }
+
+    // Thread message
+    void resetStatistics() noexcept
+    {
+        peakLoad.store (0.0f, std::memory_order_relaxed);
+        numBlocks.store (0, std::memory_order_relaxed);
+        numOverruns.store (0, std::memory_order_relaxed);
+        for (auto& bin : histogram)
+            bin.store (0, std::memory_order_relaxed);
+    }
+
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot snapshot;
+        snapshot.averageLoad = averageLoad.load (std::memory_order_relaxed);
+        snapshot.peakLoad = peakLoad.load (std::memory_order_relaxed);
+        snapshot.numBlocks = numBlocks.load (std::memory_order_relaxed);
+        snapshot.numOverruns = numOverruns.load (std::memory_order_relaxed);
+
+        for (size_t s = 0; s < (size_t) numStages; ++s)
+            snapshot.stageLoads[s] = stageLoads[s].load (std::memory_order_relaxed);
+
+        for (size_t b = 0; b < (size_t) numHistogramBins; ++b)
+            snapshot.histogram[b] = histogram[b].load (std::memory_order_relaxed);
+
+        return snapshot;
+    }
+
+    // Thread audio : un horodatage à l'entrée et un à la sortie de processBlock
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock (PerformanceMonitor& monitorToUse, int numSamplesInBlock) noexcept
+            : monitor (monitorToUse), numSamples (numSamplesInBlock), start (juce::Time::getHighResolutionTicks())
+        {
+            monitor.stageTicks.fill (0);
+        }
+
+        ~ScopedBlock() { monitor.endBlock (juce::Time::getHighResolutionTicks() - start, numSamples); }
+
+    private:
+        PerformanceMonitor& monitor;
+        int numSamples;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlock)
+    };
+
+    // Thread audio : cumule la durée de l'étape sur le bloc courant
+    class ScopedStage
+    {
+    public:
+        ScopedStage (PerformanceMonitor& monitorToUse, Stage stageToTime) noexcept
+            : monitor (monitorToUse), stage ((size_t) stageToTime), start (juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedStage() { monitor.stageTicks[stage] += juce::Time::getHighResolutionTicks() - start; }
+
+    private:
+        PerformanceMonitor& monitor;
+        size_t stage;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedStage)
+    };
+
+private:
+    double ticksPerSample = (double) juce::Time::getHighResolutionTicksPerSecond() / 44100.0;
+
+    // Thread audio uniquement
+    std::array<juce::int64, numStages> stageTicks {};
+
+    std::atomic<float> averageLoad { 0.0f }, peakLoad { 0.0f };
+    std::array<std::atomic<float>, numStages> stageLoads {};
+    std::array<std::atomic<juce::uint32>, numHistogramBins> histogram {};
+    std::atomic<juce::uint64> numBlocks { 0 }, numOverruns { 0 };
+
+    void endBlock (juce::int64 elapsedTicks, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        const auto budget = ticksPerSample * numSamples;
+        const auto load = (float) ((double) elapsedTicks / budget);
+        constexpr float smoothing = 1.0f / averagingBlocks;
+
+        // Un seul écrivain : load + store suffisent, sans boucle compare-exchange
+        const auto average = averageLoad.load (std::memory_order_relaxed);
+        averageLoad.store (average + smoothing * (load - average), std::memory_order_relaxed);
+
+        if (load > peakLoad.load (std::memory_order_relaxed))
+            peakLoad.store (load, std::memory_order_relaxed);
+
+        for (size_t s = 0; s < (size_t) numStages; ++s)
+        {
+            const auto stageLoad = (float) ((double) stageTicks[s] / budget);
+            const auto previous = stageLoads[s].load (std::memory_order_relaxed);
+            stageLoads[s].store (previous + smoothing * (stageLoad - previous), std::memory_order_relaxed);
+        }
+
+        const auto bin = juce::jlimit (0, numHistogramBins - 1, (int) (load / histogramBinWidth));
+        histogram[(size_t) bin].fetch_add (1, std::memory_order_relaxed);
+        numBlocks.fetch_add (1, std::memory_order_relaxed);
+
+        if (load > 1.0f)
+            numOverruns.fetch_add (1, std::memory_order_relaxed);
+    }
+#else
+    void prepare (double) noexcept {}
+    void resetStatistics() noexcept {}
+    Snapshot getSnapshot() const noexcept { return {}; }
+
+    struct ScopedBlock
+    {
+        ScopedBlock (PerformanceMonitor&, int) noexcept {}
+    };
+
+    struct ScopedStage
+    {
+        ScopedStage (PerformanceMonitor&, Stage) noexcept {}
+    };
+#endif
+};
@@ -0,0 +1,94 @@
+#include "ScopeChannel.h"
+
+ScopeChannel::ScopeChannel (int numChannelsToUse, int fifoSize)
+    : numChannels (numChannelsToUse),
+      fifo (fifoSize)
+{
+}
+
+template <typename SampleType>
+void ScopeChannel::push (const juce::AudioBuffer<SampleType>& buffer) noexcept
+{
+    // acquire : la FIFO allouée par setConsumerActive est visible dès que le drapeau l'est
+    if (! consumerActive.load (std::memory_order_acquire) || buffer.getNumChannels() == 0)
+        return;
+
+    // FIFO pleine : le consommateur ne tourne plus depuis toute la durée de la FIFO,
+    // ce qui ne rentre pas est perdu jusqu'à sa prochaine lecture (voir read)
+    const int numSamples = juce::jmin (buffer.getNumSamples(), fifo.getFreeSpace());
+    if (numSamples <= 0)
+        return;
+
+    const auto scope = fifo.write (numSamples);
+
+    for (int ch = 0; ch < fifoBuffer.getNumChannels(); ++ch)
+    {
+        // Un signal mono est dupliqué sur tous les canaux
+        const int sourceChannel = juce::jmin (ch, buffer.getNumChannels() - 1);
+
+        if (scope.blockSize1 > 0)
+            copyToFifo (ch, scope.startIndex1, buffer.getReadPointer (sourceChannel), scope.blockSize1);
+        if (scope.blockSize2 > 0)
+            copyToFifo (ch, scope.startIndex2, buffer.getReadPointer (sourceChannel, scope.blockSize1), scope.blockSize2);
+    }
+}
+
+template void ScopeChannel::push (const juce::AudioBuffer<float>&) noexcept;
+template void ScopeChannel::push (const juce::AudioBuffer<double>&) noexcept;
+
+void ScopeChannel::copyToFifo (int channel, int startIndex, const float* source, int numSamples) noexcept
+{
+    fifoBuffer.copyFrom (channel, startIndex, source, numSamples);
+}
+
+void ScopeChannel::copyToFifo (int channel, int startIndex, const double* source, int numSamples) noexcept
+{
+    auto* destination = fifoBuffer.getWritePointer (channel, startIndex);
+    for (int i = 0; i < numSamples; ++i)
+        destination[i] = (float) source[i];
+}
+
+void ScopeChannel::setConsumerActive (bool shouldBeActive)
+{
+    // Les échantillons restés dans la FIFO depuis la dernière activation sont périmés
+    if (shouldBeActive && ! consumerActive.load())
+    {
+        const auto scope = fifo.read (fifo.getNumReady());
+        juce::ignoreUnused (scope);
+
+        // Conservée à la désactivation : le thread audio peut encore être dans push
+        if (fifoBuffer.getNumSamples() == 0)
+        {
+            fifoBuffer.setSize (numChannels, fifo.getTotalSize());
+            fifoBuffer.clear();
+        }
+    }
+
+    consumerActive.store (shouldBeActive, std::memory_order_release);
+}
+
+int ScopeChannel::read (juce::AudioBuffer<float>& destination) noexcept
+{
+    const int numReady = fifo.getNumReady();
+    const int numToRead = juce::jmin (numReady, destination.getNumSamples());
+
+    // Les échantillons qui ne tiennent pas dans destination sont les plus anciens
+    if (numReady > numToRead)
+    {
+        const auto skipped = fifo.read (numReady - numToRead);
+        juce::ignoreUnused (skipped);
+    }
+
+    const int numChannelsToCopy = juce::jmin (destination.getNumChannels(), fifoBuffer.getNumChannels());
+    const auto scope = fifo.read (numToRead);
+
+    for (int ch = 0; ch < numChannelsToCopy; ++ch)
+    {
+        if (scope.blockSize1 > 0)
+            destination.copyFrom (ch, 0, fifoBuffer, ch, scope.startIndex1, scope.blockSize1);
+        if (scope.blockSize2 > 0)
+            destination.copyFrom (ch, scope.blockSize1, fifoBuffer, ch, scope.startIndex2, scope.blockSize2);
+    }
+
+    return scope.blockSize1 + scope.blockSize2;
+}
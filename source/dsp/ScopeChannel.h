@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Transmet les échantillons de sortie du thread audio vers l'analyse.
+// Le thread audio se contente de pousser les échantillons dans une FIFO sans
+// verrou (AbstractFifo), et seulement si un consommateur est attaché. C'est le
+// consommateur qui vide la FIFO et en fait ce dont il a besoin.
+// La FIFO n'est allouée qu'à la première activation du consommateur : un
+// processeur sans éditeur ouvert ne la paie pas.
+class ScopeChannel
+{
+public:
+    ScopeChannel (int numChannels, int fifoSize);
+
+    // Thread audio uniquement. Ne fait rien si aucun consommateur n'est attaché.
+    // Un buffer en double est converti en float à l'écriture dans la FIFO.
+    template <typename SampleType>
+    void push (const juce::AudioBuffer<SampleType>& buffer) noexcept;
+
+    // A appeler quand aucun read() n'est en cours. La première activation alloue la FIFO.
+    void setConsumerActive (bool shouldBeActive);
+    bool isConsumerActive() const noexcept { return consumerActive.load (std::memory_order_relaxed); }
+
+    // Thread du consommateur uniquement : copie au début de destination les
+    // échantillons disponibles les plus récents (au plus sa taille) et renvoie leur
+    // nombre. Un consommateur en retard saute les plus anciens au lieu de les lire.
+    int read (juce::AudioBuffer<float>& destination) noexcept;
+
+private:
+    std::atomic<bool> consumerActive { false };
+
+    const int numChannels;
+    juce::AbstractFifo fifo;
+    juce::AudioBuffer<float> fifoBuffer;
+
+    void copyToFifo (int channel, int startIndex, const float* source, int numSamples) noexcept;
+    void copyToFifo (int channel, int startIndex, const double* source, int numSamples) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScopeChannel)
+};
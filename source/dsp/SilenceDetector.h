@@ -0,0 +1,39 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Détecte une entrée silencieuse côté analyse : tant qu'aucun échantillon ne
+// dépasse le seuil pendant holdSeconds, l'AnalysisEngine ne calcule plus de
+// spectre et l'éditeur ne redessine plus rien. Le maintien laisse aux
+// affichages (relâchement du spectre, traînée du scope) le temps de retomber.
+class SilenceDetector
+{
+public:
+    static constexpr float thresholdDecibels = -90.0f;
+    static constexpr double holdSeconds = 1.0;
+
+    // Thread d'analyse, pour chaque lot d'échantillons lus
+    void update (const juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate) noexcept
+    {
+        const auto threshold = juce::Decibels::decibelsToGain (thresholdDecibels);
+
+        bool hasSound = false;
+        for (int ch = 0; ch < buffer.getNumChannels() && ! hasSound; ++ch)
+            hasSound = buffer.getMagnitude (ch, 0, numSamples) > threshold;
+
+        samplesSinceSound = hasSound ? 0 : samplesSinceSound + numSamples;
+        silent = (double) samplesSinceSound >= holdSeconds * sampleRate;
+    }
+
+    void reset() noexcept
+    {
+        samplesSinceSound = 0;
+        silent = false;
+    }
+
+    bool isSilent() const noexcept { return silent; }
+
+private:
+    juce::int64 samplesSinceSound = 0;
+    bool silent = false;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "BandSplitter.h"
+#include "WidthKernel.h"
+
+// Mesures stéréo par bande : corrélation de phase, balance L/R et rapport
+// side/mid en RMS. Les sommes viennent de la passe de largeur (WidthKernel),
+// aucune passe supplémentaire n'est faite sur les bandes. Une fois par bloc,
+// elles sont intégrées (fenêtre exponentielle) puis publiées dans des atomiques.
+class StereoMeters
+{
+public:
+    static constexpr size_t maxBands = BandCount::max;
+    static constexpr double integrationTimeSeconds = 0.3;
+
+    struct Reading
+    {
+        float correlation = 1.0f; // -1 (opposition de phase) .. +1 (mono)
+        float balance = 0.0f;     // -1 (gauche) .. +1 (droite)
+        float sideToMid = 0.0f;   // RMS side / RMS mid
+    };
+
+    void prepare (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        running = {};
+        for (auto& band : published)
+            store (band, Reading {});
+    }
+
+    // Thread audio, une fois par bloc
+    void publish (const WidthKernel::BandSums<maxBands>& blockSums, int numSamples) noexcept
+    {
+        const auto decay = std::exp (-(double) numSamples / (integrationTimeSeconds * sampleRate));
+
+        for (size_t b = 0; b < maxBands; ++b)
+        {
+            auto& sums = running[b];
+            sums.mid = sums.mid * decay + blockSums.mid[b];
+            sums.side = sums.side * decay + blockSums.side[b];
+            sums.midSide = sums.midSide * decay + blockSums.midSide[b];
+
+            store (published[b], computeReading (sums.mid, sums.side, sums.midSide));
+        }
+    }
+
+    // Thread message
+    Reading getReading (size_t band) const noexcept
+    {
+        const auto& p = published[band];
+        return { p.correlation.load (std::memory_order_relaxed), p.balance.load (std::memory_order_relaxed), p.sideToMid.load (std::memory_order_relaxed) };
+    }
+
+    // Avec m = (L + R) / 2, s = (L - R) / 2 et M = somme m², S = somme (w s)², X = somme m w s :
+    //   somme L² = M + S + 2X, somme R² = M + S - 2X, somme L R = M - S
+    // (les mesures sont des rapports : multiplier les trois sommes ne change rien)
+    static Reading computeReading (double mid, double side, double midSide) noexcept
+    {
+        constexpr double silence = 1.0e-12;
+        const auto energy = mid + side;
+
+        if (energy < silence)
+            return {};
+
+        const auto leftRight = std::sqrt (std::max (0.0, energy * energy - 4.0 * midSide * midSide));
+
+        Reading reading;
+        reading.correlation = leftRight < silence ? 0.0f : (float) ((mid - side) / leftRight);
+        reading.balance = (float) (-2.0 * midSide / energy);
+        reading.sideToMid = mid < silence ? 0.0f : (float) std::sqrt (side / mid);
+        return reading;
+    }
+
+private:
+    struct RunningSums
+    {
+        double mid = 0.0, side = 0.0, midSide = 0.0;
+    };
+
+    struct PublishedReading
+    {
+        std::atomic<float> correlation { 1.0f }, balance { 0.0f }, sideToMid { 0.0f };
+    };
+
+    double sampleRate = 44100.0;
+    std::array<RunningSums, maxBands> running {};
+    std::array<PublishedReading, maxBands> published;
+
+    static void store (PublishedReading& destination, const Reading& reading) noexcept
+    {
+        destination.correlation.store (reading.correlation, std::memory_order_relaxed);
+        destination.balance.store (reading.balance, std::memory_order_relaxed);
+        destination.sideToMid.store (reading.sideToMid, std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Échange sans attente entre un producteur et un consommateur (un thread chacun).
+// Le producteur remplit getWriteBuffer() puis appelle publish() ; le consommateur
+// appelle acquire() puis lit getReadBuffer(). Aucun des deux ne bloque jamais :
+// si le consommateur est en retard, il récupère simplement la dernière version.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Thread producteur
+    T& getWriteBuffer() noexcept { return buffers[(size_t) writeIndex]; }
+
+    void publish() noexcept
+    {
+        const auto previous = middle.exchange (writeIndex | freshBit, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    // Thread consommateur : renvoie true si un nouveau contenu a été publié
+    bool acquire() noexcept
+    {
+        if ((middle.load (std::memory_order_relaxed) & freshBit) == 0)
+            return false;
+
+        const auto previous = middle.exchange (readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const noexcept { return buffers[(size_t) readIndex]; }
+
+    // Initialisation des 3 buffers, uniquement quand aucun thread ne les utilise
+    template <typename Function>
+    void forEachBuffer (Function&& function)
+    {
+        for (auto& buffer : buffers)
+            function (buffer);
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit = 4;
+
+    std::array<T, 3> buffers {};
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> middle { 2 };
+};
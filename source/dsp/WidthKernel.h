@@ -0,0 +1,480 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <juce_dsp/juce_dsp.h>
+
+// Réglage de largeur de toutes les bandes et sommation en une seule passe.
+// Les bandes arrivent déjà en mid/side (le signal est encodé une fois avant la
+// séparation, voir PluginProcessor::processBands) :
+//   mid  = somme (mid de chaque bande)
+//   side = somme (width * side de chaque bande)
+// puis L = mid + side et R = mid - side, écrits directement dans la sortie.
+//
+// Si le mid n'a pas été séparé (mode "side seul"), numMidBands vaut 1 : le mid
+// est lu tel quel et seules les sommes du side sont disponibles par bande.
+//
+// Un filtre optionnel (SideFilter, voir MonoBass) traite le side total dans la
+// même passe, avant le décodage en L/R.
+//
+// Les échantillons sont en float ou en double (SampleType, déduit des
+// pointeurs) ; les largeurs restent en float, comme les paramètres.
+namespace WidthKernel
+{
+    template <size_t numBands, typename SampleType = float>
+    using BandPointers = std::array<const SampleType*, numBands>;
+
+    // Filtre du side par défaut : aucun code n'est généré pour lui
+    struct NoSideFilter
+    {
+        static constexpr bool isActive = false;
+
+        template <typename SampleType>
+        inline SampleType process (SampleType side) noexcept { return side; }
+    };
+
+    // Encode L/R en mid/side sur place : left reçoit le mid, right le side
+    template <typename SampleType>
+    inline void encode (SampleType* left, SampleType* right, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto l = left[i];
+            const auto r = right[i];
+            left[i] = SampleType (0.5) * (l + r);
+            right[i] = SampleType (0.5) * (l - r);
+        }
+    }
+
+    // Sommes courantes par bande, après réglage de largeur, pour les mesures
+    // stéréo (corrélation, balance, rapport M/S). Avec m le mid de la bande et
+    // d = width * side, on accumule m², d² et m * d. rawSide est side² avant
+    // réglage de largeur, pour MonoSafety (qui ne peut pas le déduire de d²
+    // quand la largeur est nulle). Sans mid séparé, mid et midSide restent à zéro.
+    template <size_t numBands, typename SampleType = float>
+    struct BandSums
+    {
+        std::array<SampleType, numBands> mid {}, side {}, midSide {}, rawSide {};
+
+        void clear() noexcept { *this = {}; }
+    };
+
+    namespace detail
+    {
+        template <size_t numBands, size_t numMidBands>
+        constexpr bool checkMidBands() noexcept
+        {
+            static_assert (numMidBands == numBands || numMidBands == 1, "Le mid est séparé comme le side, ou pas du tout");
+            return numMidBands == numBands && numBands > 1;
+        }
+    }
+
+    template <size_t numBands, size_t numMidBands, typename SampleType, typename SideFilter>
+    inline void processScalar (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& widths,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int startSample,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums,
+        SideFilter& sideFilter) noexcept
+    {
+        constexpr bool splitsMid = detail::checkMidBands<numBands, numMidBands>();
+
+        for (int i = startSample; i < numSamples; ++i)
+        {
+            SampleType mid = 0;
+            SampleType side = 0;
+
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                const auto rawSide = sideBands[b][i];
+                const auto bandSide = widths[b] * rawSide;
+                side += bandSide;
+
+                sums.side[b] += bandSide * bandSide;
+                sums.rawSide[b] += rawSide * rawSide;
+
+                if constexpr (splitsMid)
+                {
+                    const auto bandMid = midBands[b][i];
+                    mid += bandMid;
+
+                    sums.mid[b] += bandMid * bandMid;
+                    sums.midSide[b] += bandMid * bandSide;
+                }
+            }
+
+            if constexpr (! splitsMid)
+                mid = midBands[0][i];
+
+            if constexpr (SideFilter::isActive)
+                side = sideFilter.process (side);
+
+            outLeft[i] = mid + side;
+            outRight[i] = mid - side;
+        }
+    }
+
+    template <size_t numBands, size_t numMidBands, typename SampleType>
+    inline void processScalar (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& widths,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int startSample,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums) noexcept
+    {
+        NoSideFilter noFilter;
+        processScalar<numBands> (midBands, sideBands, widths, outLeft, outRight, startSample, numSamples, sums, noFilter);
+    }
+
+    template <size_t numBands, size_t numMidBands, typename SampleType>
+    inline void processScalar (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& widths,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums) noexcept
+    {
+        processScalar<numBands> (midBands, sideBands, widths, outLeft, outRight, 0, numSamples, sums);
+    }
+
+    // Variante pendant un glissement de paramètre : la largeur de chaque bande suit
+    // une rampe linéaire width = start + increment * i sur les numSamples échantillons
+    template <size_t numBands, size_t numMidBands, typename SampleType, typename SideFilter>
+    inline void processRampScalar (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& startWidths,
+        const std::array<float, numBands>& increments,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int startSample,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums,
+        SideFilter& sideFilter) noexcept
+    {
+        constexpr bool splitsMid = detail::checkMidBands<numBands, numMidBands>();
+
+        for (int i = startSample; i < numSamples; ++i)
+        {
+            SampleType mid = 0;
+            SampleType side = 0;
+
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                const auto width = startWidths[b] + increments[b] * (float) i;
+                const auto rawSide = sideBands[b][i];
+                const auto bandSide = width * rawSide;
+                side += bandSide;
+
+                sums.side[b] += bandSide * bandSide;
+                sums.rawSide[b] += rawSide * rawSide;
+
+                if constexpr (splitsMid)
+                {
+                    const auto bandMid = midBands[b][i];
+                    mid += bandMid;
+
+                    sums.mid[b] += bandMid * bandMid;
+                    sums.midSide[b] += bandMid * bandSide;
+                }
+            }
+
+            if constexpr (! splitsMid)
+                mid = midBands[0][i];
+
+            if constexpr (SideFilter::isActive)
+                side = sideFilter.process (side);
+
+            outLeft[i] = mid + side;
+            outRight[i] = mid - side;
+        }
+    }
+
+    template <size_t numBands, size_t numMidBands, typename SampleType>
+    inline void processRampScalar (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& startWidths,
+        const std::array<float, numBands>& increments,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int startSample,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums) noexcept
+    {
+        NoSideFilter noFilter;
+        processRampScalar<numBands> (midBands, sideBands, startWidths, increments, outLeft, outRight, startSample, numSamples, sums, noFilter);
+    }
+
+#if JUCE_USE_SIMD
+    namespace detail
+    {
+        template <typename SampleType>
+        using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+        // La sortie (et le mid non séparé) vient du buffer de l'hôte et n'est
+        // pas forcément alignée
+        template <typename SampleType>
+        inline void store (Vec<SampleType> value, SampleType* dest, bool isAligned) noexcept
+        {
+            if (isAligned)
+            {
+                value.copyToRawArray (dest);
+            }
+            else
+            {
+                alignas (sizeof (Vec<SampleType>)) SampleType temp[Vec<SampleType>::SIMDNumElements];
+                value.copyToRawArray (temp);
+                std::memcpy (dest, temp, sizeof (temp));
+            }
+        }
+
+        template <typename SampleType>
+        inline Vec<SampleType> load (const SampleType* source, bool isAligned) noexcept
+        {
+            if (isAligned)
+                return Vec<SampleType>::fromRawArray (source);
+
+            alignas (sizeof (Vec<SampleType>)) SampleType temp[Vec<SampleType>::SIMDNumElements];
+            std::memcpy (temp, source, sizeof (temp));
+            return Vec<SampleType>::fromRawArray (temp);
+        }
+
+        template <size_t numBands, typename SampleType>
+        inline bool areAligned (const BandPointers<numBands, SampleType>& bands) noexcept
+        {
+            for (size_t b = 0; b < numBands; ++b)
+                if (! Vec<SampleType>::isSIMDAligned (bands[b]))
+                    return false;
+
+            return true;
+        }
+
+        // Le filtre est récursif : les voies sont filtrées l'une après l'autre,
+        // dans l'ordre des échantillons
+        template <typename SampleType, typename SideFilter>
+        inline Vec<SampleType> filterSide (Vec<SampleType> side, SideFilter& sideFilter) noexcept
+        {
+            alignas (sizeof (Vec<SampleType>)) SampleType lanes[Vec<SampleType>::SIMDNumElements];
+            side.copyToRawArray (lanes);
+
+            for (auto& lane : lanes)
+                lane = sideFilter.process (lane);
+
+            return Vec<SampleType>::fromRawArray (lanes);
+        }
+
+        // Sommes par voie SIMD, réduites une seule fois en fin de boucle
+        template <size_t numBands, typename SampleType>
+        struct VecSums
+        {
+            using Register = Vec<SampleType>;
+
+            std::array<Register, numBands> mid, side, midSide, rawSide;
+
+            VecSums() noexcept
+            {
+                for (size_t b = 0; b < numBands; ++b)
+                    mid[b] = side[b] = midSide[b] = rawSide[b] = Register::expand (0);
+            }
+
+            inline void addSide (size_t b, Register bandSide, Register bandRawSide) noexcept
+            {
+                side[b] += bandSide * bandSide;
+                rawSide[b] += bandRawSide * bandRawSide;
+            }
+
+            inline void addMid (size_t b, Register bandMid, Register bandSide) noexcept
+            {
+                mid[b] += bandMid * bandMid;
+                midSide[b] += bandMid * bandSide;
+            }
+
+            void reduceInto (BandSums<numBands, SampleType>& sums) const noexcept
+            {
+                for (size_t b = 0; b < numBands; ++b)
+                {
+                    sums.mid[b] += mid[b].sum();
+                    sums.side[b] += side[b].sum();
+                    sums.midSide[b] += midSide[b].sum();
+                    sums.rawSide[b] += rawSide[b].sum();
+                }
+            }
+        };
+    }
+#endif
+
+    // Version vectorisée (SIMDRegister) si les bandes du side sont alignées, sinon scalaire
+    template <size_t numBands, size_t numMidBands, typename SampleType, typename SideFilter>
+    inline void process (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& widths,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums,
+        SideFilter& sideFilter) noexcept
+    {
+        int i = 0;
+
+#if JUCE_USE_SIMD
+        using Vec = detail::Vec<SampleType>;
+        constexpr int step = (int) Vec::SIMDNumElements;
+        constexpr bool splitsMid = detail::checkMidBands<numBands, numMidBands>();
+
+        if (detail::areAligned (sideBands))
+        {
+            const bool midAligned = detail::areAligned (midBands);
+            const bool outputAligned = Vec::isSIMDAligned (outLeft) && Vec::isSIMDAligned (outRight);
+
+            std::array<Vec, numBands> bandWidths;
+            for (size_t b = 0; b < numBands; ++b)
+                bandWidths[b] = Vec::expand ((SampleType) widths[b]);
+
+            detail::VecSums<numBands, SampleType> vecSums;
+
+            for (; i + step <= numSamples; i += step)
+            {
+                auto mid = Vec::expand (0);
+                auto side = Vec::expand (0);
+
+                for (size_t b = 0; b < numBands; ++b)
+                {
+                    const auto rawSide = Vec::fromRawArray (sideBands[b] + i);
+                    const auto bandSide = rawSide * bandWidths[b];
+                    side += bandSide;
+                    vecSums.addSide (b, bandSide, rawSide);
+
+                    if constexpr (splitsMid)
+                    {
+                        const auto bandMid = detail::load (midBands[b] + i, midAligned);
+                        mid += bandMid;
+                        vecSums.addMid (b, bandMid, bandSide);
+                    }
+                }
+
+                if constexpr (! splitsMid)
+                    mid = detail::load (midBands[0] + i, midAligned);
+
+                if constexpr (SideFilter::isActive)
+                    side = detail::filterSide (side, sideFilter);
+
+                detail::store (mid + side, outLeft + i, outputAligned);
+                detail::store (mid - side, outRight + i, outputAligned);
+            }
+
+            vecSums.reduceInto (sums);
+        }
+#endif
+
+        processScalar<numBands> (midBands, sideBands, widths, outLeft, outRight, i, numSamples, sums, sideFilter);
+    }
+
+    template <size_t numBands, size_t numMidBands, typename SampleType>
+    inline void process (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& widths,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums) noexcept
+    {
+        NoSideFilter noFilter;
+        process<numBands> (midBands, sideBands, widths, outLeft, outRight, numSamples, sums, noFilter);
+    }
+
+    template <size_t numBands, size_t numMidBands, typename SampleType, typename SideFilter>
+    inline void processRamp (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& startWidths,
+        const std::array<float, numBands>& increments,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums,
+        SideFilter& sideFilter) noexcept
+    {
+        int i = 0;
+
+#if JUCE_USE_SIMD
+        using Vec = detail::Vec<SampleType>;
+        constexpr int step = (int) Vec::SIMDNumElements;
+        constexpr bool splitsMid = detail::checkMidBands<numBands, numMidBands>();
+
+        if (detail::areAligned (sideBands))
+        {
+            const bool midAligned = detail::areAligned (midBands);
+            const bool outputAligned = Vec::isSIMDAligned (outLeft) && Vec::isSIMDAligned (outRight);
+
+            alignas (sizeof (Vec)) SampleType offsets[Vec::SIMDNumElements];
+            for (size_t n = 0; n < Vec::SIMDNumElements; ++n)
+                offsets[n] = (SampleType) n;
+
+            const auto rampOffsets = Vec::fromRawArray (offsets);
+
+            // Une rampe par bande, avancée de step échantillons à chaque itération
+            std::array<Vec, numBands> bandWidths, bandIncrements;
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                bandWidths[b] = Vec::expand ((SampleType) startWidths[b]) + rampOffsets * Vec::expand ((SampleType) increments[b]);
+                bandIncrements[b] = Vec::expand ((SampleType) increments[b] * (SampleType) step);
+            }
+
+            detail::VecSums<numBands, SampleType> vecSums;
+
+            for (; i + step <= numSamples; i += step)
+            {
+                auto mid = Vec::expand (0);
+                auto side = Vec::expand (0);
+
+                for (size_t b = 0; b < numBands; ++b)
+                {
+                    const auto rawSide = Vec::fromRawArray (sideBands[b] + i);
+                    const auto bandSide = rawSide * bandWidths[b];
+                    side += bandSide;
+                    vecSums.addSide (b, bandSide, rawSide);
+                    bandWidths[b] += bandIncrements[b];
+
+                    if constexpr (splitsMid)
+                    {
+                        const auto bandMid = detail::load (midBands[b] + i, midAligned);
+                        mid += bandMid;
+                        vecSums.addMid (b, bandMid, bandSide);
+                    }
+                }
+
+                if constexpr (! splitsMid)
+                    mid = detail::load (midBands[0] + i, midAligned);
+
+                if constexpr (SideFilter::isActive)
+                    side = detail::filterSide (side, sideFilter);
+
+                detail::store (mid + side, outLeft + i, outputAligned);
+                detail::store (mid - side, outRight + i, outputAligned);
+            }
+
+            vecSums.reduceInto (sums);
+        }
+#endif
+
+        processRampScalar<numBands> (midBands, sideBands, startWidths, increments, outLeft, outRight, i, numSamples, sums, sideFilter);
+    }
+
+    template <size_t numBands, size_t numMidBands, typename SampleType>
+    inline void processRamp (const BandPointers<numMidBands, SampleType>& midBands,
+        const BandPointers<numBands, SampleType>& sideBands,
+        const std::array<float, numBands>& startWidths,
+        const std::array<float, numBands>& increments,
+        SampleType* outLeft,
+        SampleType* outRight,
+        int numSamples,
+        BandSums<numBands, SampleType>& sums) noexcept
+    {
+        NoSideFilter noFilter;
+        processRamp<numBands> (midBands, sideBands, startWidths, increments, outLeft, outRight, numSamples, sums, noFilter);
+    }
+}
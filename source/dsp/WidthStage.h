@@ -0,0 +1,135 @@
+#pragma once
+
+#include "BandSplitter.h"
+#include "MonoBass.h"
+#include "WidthKernel.h"
+
+// Largeur par bande avec lissage des paramètres WIDTH1..8.
+// Tant qu'aucune largeur ne bouge, c'est le noyau à largeur constante qui tourne ;
+// pendant un glissement, les rampes sont évaluées par sous-blocs alignés SIMD.
+// Le passe-haut des basses mono est appliqué au side dans la même passe.
+// Les largeurs restent en float ; les échantillons sont en SampleType.
+template <typename SampleType>
+class WidthStage
+{
+public:
+    static constexpr size_t maxBands = BandCount::max;
+    static constexpr double smoothingTimeSeconds = 0.02;
+    static constexpr int rampSubBlockSize = 32;
+
+    template <size_t numBands>
+    using BandPointers = WidthKernel::BandPointers<numBands, SampleType>;
+
+    // Les sommes des mesures restent en float quelle que soit la précision
+    using BandSums = WidthKernel::BandSums<maxBands>;
+
+    void prepare (double sampleRate, const std::array<float, maxBands>& initialWidths)
+    {
+        for (size_t b = 0; b < maxBands; ++b)
+        {
+            widths[b].reset (sampleRate, smoothingTimeSeconds);
+            widths[b].setCurrentAndTargetValue (initialWidths[b]);
+        }
+
+        monoBass.prepare (sampleRate);
+    }
+
+    // Basses mono sous frequency (en Hz). Appelé avant prepare, le réglage est
+    // pris tel quel ; ensuite, la coupure glisse.
+    void setMonoBass (bool enabled, float frequency) noexcept { monoBass.setTarget (enabled, frequency); }
+
+    void setTargetWidths (const std::array<float, maxBands>& newWidths) noexcept
+    {
+        for (size_t b = 0; b < maxBands; ++b)
+            widths[b].setTargetValue (newWidths[b]);
+    }
+
+    // Bandes en mid/side ; midBands peut ne contenir que le mid entier (voir
+    // WidthKernel). Seules les numBands premières largeurs sont lues et glissent.
+    template <size_t numBands, size_t numMidBands>
+    void process (const BandPointers<numMidBands>& midBands, const BandPointers<numBands>& sideBands, SampleType* outLeft, SampleType* outRight, int numSamples) noexcept
+    {
+        static_assert (numBands <= maxBands);
+
+        // Sans basses mono, le noyau est celui sans filtre
+        if (monoBass.isBypassed())
+        {
+            WidthKernel::NoSideFilter noFilter;
+            processWith<numBands> (midBands, sideBands, outLeft, outRight, numSamples, noFilter);
+        }
+        else
+        {
+            monoBass.advance (numSamples);
+            processWith<numBands> (midBands, sideBands, outLeft, outRight, numSamples, monoBass);
+        }
+    }
+
+    // Sommes pour les mesures stéréo, accumulées par process jusqu'au prochain clearSums
+    // (les bandes inutilisées restent à zéro)
+    const BandSums& getSums() const noexcept { return sums; }
+    void clearSums() noexcept { sums.clear(); }
+
+private:
+    std::array<juce::SmoothedValue<float>, maxBands> widths;
+    BandSums sums;
+    MonoBass<SampleType> monoBass;
+
+    template <size_t numBands, size_t numMidBands, typename SideFilter>
+    void processWith (const BandPointers<numMidBands>& midBands, const BandPointers<numBands>& sideBands, SampleType* outLeft, SampleType* outRight, int numSamples, SideFilter& sideFilter) noexcept
+    {
+        WidthKernel::BandSums<numBands, SampleType> blockSums;
+
+        for (int start = 0; start < numSamples;)
+        {
+            if (! isSmoothing<numBands>())
+            {
+                std::array<float, numBands> current;
+                for (size_t b = 0; b < numBands; ++b)
+                    current[b] = widths[b].getCurrentValue();
+
+                WidthKernel::process<numBands> (offset (midBands, start), offset (sideBands, start), current, outLeft + start, outRight + start, numSamples - start, blockSums, sideFilter);
+                break;
+            }
+
+            const int length = juce::jmin (rampSubBlockSize, numSamples - start);
+
+            std::array<float, numBands> startWidths, increments;
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                startWidths[b] = widths[b].getCurrentValue();
+                increments[b] = (widths[b].skip (length) - startWidths[b]) / (float) length;
+            }
+
+            WidthKernel::processRamp<numBands> (offset (midBands, start), offset (sideBands, start), startWidths, increments, outLeft + start, outRight + start, length, blockSums, sideFilter);
+            start += length;
+        }
+
+        for (size_t b = 0; b < numBands; ++b)
+        {
+            sums.mid[b] += (float) blockSums.mid[b];
+            sums.side[b] += (float) blockSums.side[b];
+            sums.midSide[b] += (float) blockSums.midSide[b];
+            sums.rawSide[b] += (float) blockSums.rawSide[b];
+        }
+    }
+
+    template <size_t numBands>
+    bool isSmoothing() const noexcept
+    {
+        for (size_t b = 0; b < numBands; ++b)
+            if (widths[b].isSmoothing())
+                return true;
+
+        return false;
+    }
+
+    template <size_t numBands>
+    static BandPointers<numBands> offset (const BandPointers<numBands>& pointers, int start) noexcept
+    {
+        BandPointers<numBands> result;
+        for (size_t b = 0; b < numBands; ++b)
+            result[b] = pointers[b] + start;
+
+        return result;
+    }
+};
@@ -0,0 +1,137 @@
+#include "PluginState.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr char magic[4] = { 'S', '2', '3', 'R' };
+
+    // Garde-fou contre un nombre absurde lu dans des données corrompues
+    constexpr int maxStoredParameters = 4096;
+}
+
+PluginState::PluginState (juce::AudioProcessorValueTreeState& stateToUse)
+{
+    for (auto* parameter : stateToUse.processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter))
+            parameters.push_back ({ ranged, ranged->getParameterID() });
+}
+
+PluginState::Snapshot PluginState::capture() const
+{
+    Snapshot snapshot;
+    snapshot.reserve (parameters.size());
+
+    for (auto& entry : parameters)
+        snapshot.push_back (entry.parameter->getValue());
+
+    return snapshot;
+}
+
+void PluginState::apply (const Snapshot& snapshot, bool asGesture) const
+{
+    jassert (snapshot.size() == parameters.size());
+
+    for (size_t i = 0; i < juce::jmin (snapshot.size(), parameters.size()); ++i)
+    {
+        auto* parameter = parameters[i].parameter;
+        if (parameter->getValue() == snapshot[i])
+            continue;
+
+        if (asGesture)
+            parameter->beginChangeGesture();
+
+        parameter->setValueNotifyingHost (snapshot[i]);
+
+        if (asGesture)
+            parameter->endChangeGesture();
+    }
+}
+
+void PluginState::write (juce::MemoryBlock& destination) const
+{
+    write (capture(), destination);
+}
+
+void PluginState::write (const Snapshot& snapshot, juce::MemoryBlock& destination) const
+{
+    jassert (snapshot.size() == parameters.size());
+
+    destination.reset();
+    juce::MemoryOutputStream out (destination, false);
+
+    out.write (magic, sizeof (magic));
+    out.writeInt (currentVersion);
+    out.writeCompressedInt ((int) parameters.size());
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        out.writeString (parameters[i].id);
+        out.writeFloat (snapshot[i]);
+    }
+}
+
+bool PluginState::read (const void* data, int sizeInBytes, Snapshot& snapshot) const
+{
+    if (data == nullptr || sizeInBytes < (int) sizeof (magic) + 4)
+        return false;
+
+    juce::MemoryInputStream in (data, (size_t) sizeInBytes, false);
+
+    char header[sizeof (magic)];
+    if (in.read (header, sizeof (header)) != (int) sizeof (header) || std::memcmp (header, magic, sizeof (magic)) != 0)
+        return false;
+
+    const auto version = in.readInt();
+    if (version < 1 || version > currentVersion)
+        return false;
+
+    const auto numStored = in.readCompressedInt();
+    if (numStored < 0 || numStored > maxStoredParameters)
+        return false;
+
+    // Les paramètres absents des données reprennent leur valeur par défaut
+    Snapshot result;
+    result.reserve (parameters.size());
+    for (auto& entry : parameters)
+        result.push_back (entry.parameter->getDefaultValue());
+
+    for (int i = 0; i < numStored; ++i)
+    {
+        const auto id = in.readString();
+        if (in.getNumBytesRemaining() < 4)
+            return false;
+
+        const auto value = in.readFloat();
+        const auto index = findParameter (id, (size_t) i);
+
+        if (index >= 0 && std::isfinite (value))
+            result[(size_t) index] = juce::jlimit (0.0f, 1.0f, value);
+    }
+
+    snapshot = std::move (result);
+    return true;
+}
+
+bool PluginState::restore (const void* data, int sizeInBytes) const
+{
+    Snapshot snapshot;
+    if (! read (data, sizeInBytes, snapshot))
+        return false;
+
+    apply (snapshot, false);
+    return true;
+}
+
+int PluginState::findParameter (const juce::String& id, size_t hint) const noexcept
+{
+    // Cas courant : même ordre qu'à l'écriture
+    if (hint < parameters.size() && parameters[hint].id == id)
+        return (int) hint;
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+        if (parameters[i].id == id)
+            return (int) i;
+
+    return -1;
+}
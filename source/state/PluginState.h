@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+// Sauvegarde et rappel de tous les paramètres de l'apvts (largeurs, fréquences
+// de séparation, pente, modes...) dans un format binaire compact et versionné :
+//
+//   "S23R"          4 octets
+//   version         int32 little-endian
+//   n               entier compressé (juce::MemoryOutputStream::writeCompressedInt)
+//   n fois          identifiant (UTF-8 terminé par zéro), valeur normalisée (float32)
+//
+// Les paramètres sont retrouvés par identifiant : un état écrit par une version
+// qui avait moins de paramètres se recharge, les absents reprennent leur défaut,
+// les inconnus sont ignorés. Une version plus récente que currentVersion est refusée.
+class PluginState
+{
+public:
+    static constexpr int currentVersion = 1;
+
+    // Valeurs normalisées de tous les paramètres, dans l'ordre de l'AudioProcessor
+    using Snapshot = std::vector<float>;
+
+    explicit PluginState (juce::AudioProcessorValueTreeState& stateToUse);
+
+    Snapshot capture() const;
+
+    // asGesture : entoure chaque changement d'un geste, pour que l'hôte l'enregistre
+    // comme une action de l'utilisateur (changement de preset). Seuls les
+    // paramètres qui changent sont notifiés.
+    void apply (const Snapshot& snapshot, bool asGesture) const;
+
+    void write (juce::MemoryBlock& destination) const;
+    void write (const Snapshot& snapshot, juce::MemoryBlock& destination) const;
+
+    // false (et snapshot inchangé) si les données ne sont pas un état valide
+    bool read (const void* data, int sizeInBytes, Snapshot& snapshot) const;
+    bool restore (const void* data, int sizeInBytes) const;
+
+    size_t getNumParameters() const noexcept { return parameters.size(); }
+
+private:
+    struct Entry
+    {
+        juce::RangedAudioParameter* parameter;
+        juce::String id;
+    };
+
+    std::vector<Entry> parameters;
+
+    int findParameter (const juce::String& id, size_t hint) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginState)
+};
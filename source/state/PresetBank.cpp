@@ -0,0 +1,53 @@
+#include "PresetBank.h"
+
+int PresetBank::addCurrentState (const juce::String& name)
+{
+    return addPreset (name, state.capture());
+}
+
+int PresetBank::addPreset (const juce::String& name, PluginState::Snapshot values)
+{
+    jassert (values.size() == state.getNumParameters());
+
+    presets.push_back ({ name, std::move (values) });
+    return (int) presets.size() - 1;
+}
+
+int PresetBank::addPreset (const juce::String& name, const void* data, int sizeInBytes)
+{
+    PluginState::Snapshot values;
+    if (! state.read (data, sizeInBytes, values))
+        return -1;
+
+    return addPreset (name, std::move (values));
+}
+
+juce::String PresetBank::getPresetName (int index) const
+{
+    return isValidIndex (index) ? presets[(size_t) index].name : juce::String();
+}
+
+void PresetBank::setPresetName (int index, const juce::String& newName)
+{
+    if (isValidIndex (index))
+        presets[(size_t) index].name = newName;
+}
+
+bool PresetBank::loadPreset (int index)
+{
+    if (! isValidIndex (index))
+        return false;
+
+    state.apply (presets[(size_t) index].values, true);
+    currentPreset = index;
+    return true;
+}
+
+bool PresetBank::writePreset (int index, juce::MemoryBlock& destination) const
+{
+    if (! isValidIndex (index))
+        return false;
+
+    state.write (presets[(size_t) index].values, destination);
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PluginState.h"
+
+// Presets gardés en mémoire sous forme de Snapshot déjà décodés : changer de
+// preset n'est qu'une boucle de setValueNotifyingHost, sans décodage ni allocation.
+//
+// Rien n'est remis à zéro côté DSP : les largeurs et les fréquences de séparation
+// glissent vers leurs nouvelles valeurs avec les lissages du thread audio. Les
+// réglages discrets (nombre de bandes, pente, modes) changent au bloc suivant.
+class PresetBank
+{
+public:
+    explicit PresetBank (const PluginState& stateToUse) : state (stateToUse) {}
+
+    // Thread message. Retourne l'index du preset ajouté.
+    int addCurrentState (const juce::String& name);
+    int addPreset (const juce::String& name, PluginState::Snapshot values);
+
+    // -1 si les données ne sont pas un état valide
+    int addPreset (const juce::String& name, const void* data, int sizeInBytes);
+
+    int getNumPresets() const noexcept { return (int) presets.size(); }
+    juce::String getPresetName (int index) const;
+    void setPresetName (int index, const juce::String& newName);
+
+    // Thread message : applique le preset comme un geste de l'utilisateur
+    bool loadPreset (int index);
+    int getCurrentPreset() const noexcept { return currentPreset; }
+
+    bool writePreset (int index, juce::MemoryBlock& destination) const;
+
+private:
+    struct Preset
+    {
+        juce::String name;
+        PluginState::Snapshot values;
+    };
+
+    const PluginState& state;
+    std::vector<Preset> presets;
+    int currentPreset = 0;
+
+    bool isValidIndex (int index) const noexcept { return juce::isPositiveAndBelow (index, (int) presets.size()); }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetBank)
+};
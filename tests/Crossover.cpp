@@ -0,0 +1,145 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <dsp/BandWorkspace.h>
+#include <dsp/CrossoverEngine.h>
+
+TEMPLATE_TEST_CASE ("Crossover bands sum to a flat magnitude response", "[dsp]", float, double)
+{
+    constexpr int fftOrder = 14;
+    constexpr int fftSize = 1 << fftOrder;
+
+    for (int numBands = BandCount::min; numBands <= BandCount::max; ++numBands)
+    {
+        for (auto slope : { CrossoverSlope::lr2, CrossoverSlope::lr4, CrossoverSlope::lr8 })
+        {
+            CrossoverEngine<TestType> crossover;
+            crossover.setSlope (slope);
+            crossover.setNumBands (numBands);
+            crossover.setCrossoverFrequencies ({ 80.0f, 250.0f, 800.0f, 2000.0f, 5000.0f, 9000.0f, 15000.0f });
+            crossover.prepare ({ 48000.0, (juce::uint32) fftSize, 2 });
+
+            BandWorkspace<TestType> workspace;
+            workspace.prepare (2, fftSize);
+
+            juce::HeapBlock<char> storage;
+            juce::dsp::AudioBlock<TestType> impulse (storage, 2, fftSize);
+            impulse.clear();
+            impulse.setSample (0, 0, 1);
+            impulse.setSample (1, 0, 1);
+
+            typename CrossoverEngine<TestType>::BandBlocks bands;
+            for (int b = 0; b < BandCount::max; ++b)
+                bands[(size_t) b] = workspace.getBand (b, 2, fftSize);
+
+            crossover.process (impulse, bands);
+
+            std::vector<float> fftData (fftSize * 2, 0.0f);
+            for (int b = 0; b < numBands; ++b)
+                for (int i = 0; i < fftSize; ++i)
+                    fftData[(size_t) i] += (float) bands[(size_t) b].getSample (0, i);
+
+            juce::dsp::FFT fft (fftOrder);
+            fft.performFrequencyOnlyForwardTransform (fftData.data());
+
+            for (int bin = 1; bin < fftSize / 2; ++bin)
+            {
+                INFO (numBands << " bands, slope " << (int) slope << ", bin " << bin);
+                REQUIRE (std::abs (juce::Decibels::gainToDecibels (fftData[(size_t) bin])) < 0.01f);
+            }
+        }
+    }
+}
+
+TEST_CASE ("Crossover sends each band's energy to its own output", "[dsp]")
+{
+    CrossoverEngine<float> crossover;
+    crossover.setNumBands (3);
+    crossover.setCrossoverFrequencies ({ 200.0f, 2000.0f, 5000.0f, 8000.0f, 11000.0f, 14000.0f, 17000.0f });
+    crossover.prepare ({ 48000.0, 4800, 1 });
+
+    BandWorkspace<float> workspace;
+    workspace.prepare (1, 4800);
+
+    // 1 kHz lies between the two crossovers of a 3-band split
+    juce::HeapBlock<char> storage;
+    juce::dsp::AudioBlock<float> sine (storage, 1, 4800);
+    for (int i = 0; i < 4800; ++i)
+        sine.setSample (0, i, std::sin (juce::MathConstants<float>::twoPi * 1000.0f * (float) i / 48000.0f));
+
+    CrossoverEngine<float>::BandBlocks bands;
+    for (int b = 0; b < BandCount::max; ++b)
+        bands[(size_t) b] = workspace.getBand (b, 1, 4800);
+
+    crossover.process (sine, bands);
+
+    // Skip the filters' settling time
+    const auto rms = [] (const juce::dsp::AudioBlock<float>& band) {
+        double sum = 0.0;
+        for (int i = 2400; i < 4800; ++i)
+            sum += band.getSample (0, i) * band.getSample (0, i);
+        return std::sqrt (sum / 2400.0);
+    };
+
+    CHECK (rms (bands[1]) > 0.6);
+    CHECK (rms (bands[0]) < 0.1);
+    CHECK (rms (bands[2]) < 0.1);
+}
+
+TEST_CASE ("Side-only split keeps the mid in phase with the split side", "[dsp]")
+{
+    constexpr int numSamples = 2048;
+
+    for (int numBands : { 2, 5, 8 })
+    {
+        for (auto slope : { CrossoverSlope::lr2, CrossoverSlope::lr4, CrossoverSlope::lr8 })
+        {
+            CrossoverEngine<float> full, sideOnly;
+            for (auto* crossover : { &full, &sideOnly })
+            {
+                crossover->setSlope (slope);
+                crossover->setNumBands (numBands);
+                crossover->setCrossoverFrequencies ({ 80.0f, 250.0f, 800.0f, 2000.0f, 5000.0f, 9000.0f, 15000.0f });
+                crossover->prepare ({ 48000.0, (juce::uint32) numSamples, 2 });
+            }
+
+            BandWorkspace<float> fullWorkspace, sideOnlyWorkspace;
+            fullWorkspace.prepare (2, numSamples);
+            sideOnlyWorkspace.prepare (2, numSamples);
+
+            CrossoverEngine<float>::BandBlocks fullBands, sideOnlyBands;
+            for (int b = 0; b < BandCount::max; ++b)
+            {
+                fullBands[(size_t) b] = fullWorkspace.getBand (b, 2, numSamples);
+                sideOnlyBands[(size_t) b] = sideOnlyWorkspace.getBand (b, 2, numSamples);
+            }
+
+            // Mid in channel 0, side in channel 1
+            juce::Random random (numBands);
+            juce::HeapBlock<char> storage;
+            juce::dsp::AudioBlock<float> midSide (storage, 2, numSamples);
+            for (size_t ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    midSide.setSample ((int) ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+            full.process (midSide, fullBands);
+            BandCount::dispatch (numBands, [&] (auto n) {
+                sideOnly.processSideOnly<decltype (n)::value> (midSide, sideOnlyBands.data());
+            });
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                INFO (numBands << " bands, slope " << (int) slope << ", sample " << i);
+
+                // The mid all-pass is the sum of the mid bands
+                float midSum = 0.0f;
+                for (int b = 0; b < numBands; ++b)
+                    midSum += fullBands[(size_t) b].getSample (0, i);
+
+                REQUIRE (std::abs (midSide.getSample (0, i) - midSum) < 1.0e-4f);
+
+                for (int b = 0; b < numBands; ++b)
+                    REQUIRE (sideOnlyBands[(size_t) b].getSample (1, i) == fullBands[(size_t) b].getSample (1, i));
+            }
+        }
+    }
+}
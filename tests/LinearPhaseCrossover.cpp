@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dsp/LinearPhaseCrossover.h>
+
+namespace
+{
+    // Runs the input through the crossover in host-sized blocks that don't line
+    // up with the partition size and returns the sum of the bands
+    std::vector<float> processAndSum (LinearPhaseCrossover& crossover, const std::vector<float>& input, int blockSize, int numBands)
+    {
+        const auto numSamples = (int) input.size();
+        juce::AudioBuffer<float> in (1, numSamples);
+        in.copyFrom (0, 0, input.data(), numSamples);
+
+        std::array<juce::AudioBuffer<float>, LinearPhaseCrossover::maxBands> bands;
+        for (auto& band : bands)
+            band.setSize (1, numSamples);
+
+        std::array<juce::dsp::AudioBlock<float>, LinearPhaseCrossover::maxBands> blocks;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const auto length = (size_t) juce::jmin (blockSize, numSamples - start);
+            auto sub = [&] (juce::AudioBuffer<float>& buffer) { return juce::dsp::AudioBlock<float> (buffer).getSubBlock ((size_t) start, length); };
+            for (size_t b = 0; b < blocks.size(); ++b)
+                blocks[b] = sub (bands[b]);
+
+            crossover.process (sub (in), blocks.data(), numBands);
+        }
+
+        std::vector<float> sum ((size_t) numSamples, 0.0f);
+        for (int b = 0; b < numBands; ++b)
+            for (int i = 0; i < numSamples; ++i)
+                sum[(size_t) i] += bands[(size_t) b].getSample (0, i);
+
+        return sum;
+    }
+}
+
+TEST_CASE ("Linear-phase crossover bands sum to a delayed impulse", "[dsp]")
+{
+    for (int numBands : { 2, 4, 8 })
+    {
+        LinearPhaseCrossover crossover;
+        crossover.setCrossoverFrequencies ({ 120.0f, 500.0f, 1200.0f, 2500.0f, 5000.0f, 8000.0f, 12000.0f });
+        crossover.setNumBands (numBands);
+        crossover.prepare (48000.0, 1);
+
+        constexpr int latency = LinearPhaseCrossover::getLatencySamples();
+        std::vector<float> impulse (latency + 1500, 0.0f);
+        impulse[0] = 1.0f;
+
+        const auto sum = processAndSum (crossover, impulse, 300, numBands);
+
+        for (size_t i = 0; i < sum.size(); ++i)
+        {
+            INFO (numBands << " bands, sample " << i);
+            REQUIRE_THAT (sum[i], Catch::Matchers::WithinAbs ((int) i == latency ? 1.0 : 0.0, 1.0e-5));
+        }
+    }
+}
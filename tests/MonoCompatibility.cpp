@@ -0,0 +1,119 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <dsp/MonoSafety.h>
+#include <dsp/WidthStage.h>
+
+namespace
+{
+    // Side to mid energy ratio (dB) of the second half of one second of a
+    // left-only sine, at width 2
+    double sideToMidDecibels (float frequency, bool monoBass)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int numSamples = 48000;
+        constexpr int blockSize = 512;
+
+        std::array<float, BandCount::max> widths;
+        widths.fill (2.0f);
+
+        WidthStage<float> stage;
+        stage.setMonoBass (monoBass, 120.0f);
+        stage.prepare (sampleRate, widths);
+
+        // A left-only signal has equal mid and side, here split evenly between the bands
+        juce::HeapBlock<char> storage;
+        juce::dsp::AudioBlock<float> input (storage, 1, numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            input.setSample (0, i, 0.25f * (float) std::sin (juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+
+        std::vector<float> outLeft (numSamples), outRight (numSamples);
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const auto* x = input.getChannelPointer (0) + start;
+            const WidthStage<float>::BandPointers<2> bands { x, x };
+            stage.process (bands, bands, outLeft.data() + start, outRight.data() + start, juce::jmin (blockSize, numSamples - start));
+        }
+
+        double mid = 0.0, side = 0.0;
+        for (int i = numSamples / 2; i < numSamples; ++i)
+        {
+            const double m = outLeft[(size_t) i] + outRight[(size_t) i];
+            const double s = outLeft[(size_t) i] - outRight[(size_t) i];
+            mid += m * m;
+            side += s * s;
+        }
+
+        return 10.0 * std::log10 (side / mid);
+    }
+}
+
+TEST_CASE ("Mono bass removes the side below its cutoff", "[dsp]")
+{
+    // Width 2 on a left-only signal: side is twice the mid (+6 dB)
+    CHECK (sideToMidDecibels (40.0f, false) == Catch::Approx (6.02).margin (0.01));
+    CHECK (sideToMidDecibels (1000.0f, false) == Catch::Approx (6.02).margin (0.01));
+
+    // 48 dB/oct: 40 Hz is 1.6 octaves under 120 Hz
+    CHECK (sideToMidDecibels (40.0f, true) < -60.0);
+    CHECK (sideToMidDecibels (1000.0f, true) == Catch::Approx (6.02).margin (0.1));
+}
+
+TEST_CASE ("Mono safety caps the width from the running correlation", "[dsp]")
+{
+    MonoSafety safety;
+    safety.prepare (48000.0);
+
+    // Band 0 is uncorrelated (M = D), band 1 nearly mono, band 2 silent
+    WidthKernel::BandSums<MonoSafety::maxBands> sums;
+    sums.mid[0] = 100.0f;
+    sums.rawSide[0] = 100.0f;
+    sums.mid[1] = 100.0f;
+    sums.rawSide[1] = 1.0f;
+
+    std::array<float, MonoSafety::maxBands> widths;
+
+    SECTION ("off by default")
+    {
+        safety.update (sums, 512);
+        widths.fill (2.0f);
+        safety.limit (widths);
+        CHECK (widths[0] == 2.0f);
+    }
+
+    SECTION ("a minimum correlation of 0 keeps side under mid")
+    {
+        safety.setMinimumCorrelation (0.0f);
+        safety.update (sums, 512);
+
+        widths.fill (2.0f);
+        safety.limit (widths);
+        CHECK (widths[0] == Catch::Approx (1.0f));
+        CHECK (widths[1] == 2.0f);
+        CHECK (widths[2] == 2.0f);
+
+        // Narrower settings are left alone
+        widths.fill (0.5f);
+        safety.limit (widths);
+        CHECK (widths[0] == 0.5f);
+    }
+
+    SECTION ("a minimum correlation of 1 folds the band to mono")
+    {
+        safety.setMinimumCorrelation (1.0f);
+        safety.update (sums, 512);
+
+        widths.fill (1.0f);
+        safety.limit (widths);
+        CHECK (widths[0] == 0.0f);
+        CHECK (widths[1] == 0.0f);
+    }
+
+    SECTION ("the limit is measured before width, so it works at width 0")
+    {
+        safety.setMinimumCorrelation (0.6f);
+        safety.update (sums, 512);
+
+        // (1 - 0.6) / (1 + 0.6) = 0.25, the cap is sqrt (0.25)
+        CHECK (safety.getLimit (0) == Catch::Approx (0.5f));
+    }
+}
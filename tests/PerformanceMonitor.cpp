@@ -0,0 +1,37 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("PerformanceMonitor records every processed block", "[performance]")
+{
+    if constexpr (! PerformanceMonitor::isEnabled())
+        SKIP ("built with SR23_PERFORMANCE_MONITOR=0");
+
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, 256);
+
+    juce::AudioBuffer<float> buffer (2, 256);
+    juce::MidiBuffer midi;
+    juce::Random random (1);
+
+    for (int block = 0; block < 50; ++block)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < 256; ++i)
+                buffer.setSample (ch, i, random.nextFloat() - 0.5f);
+
+        plugin.processBlock (buffer, midi);
+    }
+
+    const auto snapshot = plugin.getPerformanceMonitor().getSnapshot();
+    CHECK (snapshot.numBlocks == 50);
+    CHECK (snapshot.averageLoad > 0.0f);
+    CHECK (snapshot.peakLoad >= snapshot.averageLoad);
+
+    juce::uint64 histogramTotal = 0;
+    for (auto count : snapshot.histogram)
+        histogramTotal += count;
+    CHECK (histogramTotal == snapshot.numBlocks);
+
+    plugin.resetPerformanceStatistics();
+    CHECK (plugin.getPerformanceMonitor().getSnapshot().numBlocks == 0);
+}
@@ -28,3 +28,48 @@ TEST_CASE ("IPP version", "[ipp]")
     CHECK_THAT (ippsGetLibVersion()->Version, Catch::Matchers::Equals ("2022.2.0 (r0x42db1a66)"));
 }
 #endif
+
+TEST_CASE ("Crossover frequencies past Nyquist or out of order keep the output finite", "[dsp]")
+{
+    PluginProcessor plugin;
+
+    const auto set = [&plugin] (const juce::String& id, float value) {
+        auto* parameter = plugin.apvts.getParameter (id);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    };
+
+    // 8 bands, XOVER7 above the 16 kHz Nyquist of 32 kHz, XOVER3 below XOVER2
+    set ("BANDS", 6.0f);
+    set ("XOVER7", 20000.0f);
+    set ("XOVER3", 100.0f);
+
+    plugin.prepareToPlay (32000.0, 512);
+
+    juce::AudioBuffer<float> buffer (2, 512);
+    juce::MidiBuffer midi;
+    juce::Random random;
+
+    for (int block = 0; block < 64; ++block)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        plugin.processBlock (buffer, midi);
+
+        bool isFinite = true;
+        float peak = 0.0f;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                isFinite = isFinite && std::isfinite (buffer.getSample (ch, i));
+                peak = std::max (peak, std::abs (buffer.getSample (ch, i)));
+            }
+        }
+
+        INFO ("block " << block);
+        REQUIRE (isFinite);
+        REQUIRE (peak < 10.0f);
+    }
+}
@@ -0,0 +1,121 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+
+namespace
+{
+    void setParameter (PluginProcessor& plugin, const juce::String& id, float value)
+    {
+        auto* parameter = plugin.apvts.getParameter (id);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    float getParameter (PluginProcessor& plugin, const juce::String& id)
+    {
+        return plugin.apvts.getRawParameterValue (id)->load();
+    }
+}
+
+TEST_CASE ("State round-trips every parameter", "[state]")
+{
+    PluginProcessor source;
+    setParameter (source, "WIDTH3", 1.7f);
+    setParameter (source, "XOVER2", 1800.0f);
+    setParameter (source, "BANDS", 3.0f);
+    setParameter (source, "SLOPE", 2.0f);
+
+    juce::MemoryBlock state;
+    source.getStateInformation (state);
+
+    // Binaire, pas du XML
+    REQUIRE (state.getSize() > 4);
+    CHECK (std::memcmp (state.getData(), "S23R", 4) == 0);
+
+    PluginProcessor destination;
+    destination.setStateInformation (state.getData(), (int) state.getSize());
+
+    CHECK (getParameter (destination, "WIDTH3") == getParameter (source, "WIDTH3"));
+    CHECK (getParameter (destination, "XOVER2") == getParameter (source, "XOVER2"));
+    CHECK (getParameter (destination, "BANDS") == 3.0f);
+    CHECK (getParameter (destination, "SLOPE") == 2.0f);
+    CHECK (getParameter (destination, "WIDTH1") == 1.0f);
+}
+
+TEST_CASE ("Invalid state leaves the parameters untouched", "[state]")
+{
+    PluginProcessor plugin;
+
+    juce::MemoryBlock valid;
+    plugin.getStateInformation (valid);
+
+    juce::MemoryBlock futureVersion (valid);
+    static_cast<char*> (futureVersion.getData())[4] = (char) (PluginState::currentVersion + 1);
+
+    const juce::MemoryBlock truncated (valid.getData(), valid.getSize() - 2);
+    const juce::MemoryBlock xml ("<?xml version=\"1.0\"?>", 21);
+
+    setParameter (plugin, "WIDTH2", 0.5f);
+
+    for (auto* state : { &futureVersion, &truncated, &xml })
+    {
+        plugin.setStateInformation (state->getData(), (int) state->getSize());
+        CHECK (getParameter (plugin, "WIDTH2") == Catch::Approx (0.5f));
+    }
+}
+
+TEST_CASE ("Missing parameters fall back to their defaults", "[state]")
+{
+    PluginProcessor plugin;
+    setParameter (plugin, "WIDTH4", 0.0f);
+
+    // Un état d'une version qui ne connaissait que WIDTH1
+    juce::MemoryBlock state;
+    {
+        juce::MemoryOutputStream out (state, false);
+        out.write ("S23R", 4);
+        out.writeInt (1);
+        out.writeCompressedInt (2);
+        out.writeString ("WIDTH1");
+        out.writeFloat (0.25f);
+        out.writeString ("NOT_A_PARAMETER");
+        out.writeFloat (1.0f);
+    }
+
+    plugin.setStateInformation (state.getData(), (int) state.getSize());
+
+    CHECK (getParameter (plugin, "WIDTH1") == Catch::Approx (0.5f));
+    CHECK (getParameter (plugin, "WIDTH4") == 1.0f);
+}
+
+TEST_CASE ("Preset bank switches between stored states", "[state]")
+{
+    PluginProcessor plugin;
+    auto& bank = plugin.getPresetBank();
+    REQUIRE (bank.getNumPresets() == 1);
+
+    setParameter (plugin, "WIDTH1", 2.0f);
+    setParameter (plugin, "XOVER1", 90.0f);
+    const auto wide = bank.addCurrentState ("Wide");
+
+    CHECK (plugin.getNumPrograms() == 2);
+    CHECK (plugin.getProgramName (wide) == "Wide");
+
+    plugin.setCurrentProgram (0);
+    CHECK (getParameter (plugin, "WIDTH1") == 1.0f);
+    CHECK (getParameter (plugin, "XOVER1") == Catch::Approx (200.0f));
+
+    plugin.setCurrentProgram (wide);
+    CHECK (plugin.getCurrentProgram() == wide);
+    CHECK (getParameter (plugin, "WIDTH1") == 2.0f);
+
+    // Un preset exporté se recharge dans une autre instance
+    juce::MemoryBlock data;
+    REQUIRE (bank.writePreset (wide, data));
+
+    PluginProcessor other;
+    const auto imported = other.getPresetBank().addPreset ("Imported", data.getData(), (int) data.getSize());
+    REQUIRE (imported >= 0);
+    other.setCurrentProgram (imported);
+    CHECK (getParameter (other, "WIDTH1") == 2.0f);
+}
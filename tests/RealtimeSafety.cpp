@@ -0,0 +1,126 @@
+#include "helpers/allocation_guard.h"
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("processBlock does not allocate", "[realtime]")
+{
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, 512);
+
+    juce::AudioBuffer<float> storage (2, 2048);
+    juce::MidiBuffer midi;
+    juce::Random random;
+
+    // 2048 is larger than the prepared block size and has to be processed in chunks
+    for (auto blockSize : { 64, 512, 17, 2048 })
+    {
+        for (int ch = 0; ch < storage.getNumChannels(); ++ch)
+            for (int i = 0; i < storage.getNumSamples(); ++i)
+                storage.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        juce::AudioBuffer<float> buffer (storage.getArrayOfWritePointers(), 2, blockSize);
+
+        const auto numAllocations = [&] {
+            ScopedAllocationGuard guard;
+            plugin.processBlock (buffer, midi);
+            return guard.getNumAllocations();
+        }();
+
+        INFO ("block size " << blockSize);
+        CHECK (numAllocations == 0);
+    }
+}
+
+TEST_CASE ("processBlock does not allocate when oversampling", "[realtime]")
+{
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, 512);
+
+    juce::AudioBuffer<float> buffer (2, 512);
+    juce::MidiBuffer midi;
+    juce::Random random;
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    auto* oversampling = plugin.apvts.getParameter ("OVERSAMPLING");
+
+    for (auto choice : { 1, 2, 0 })
+    {
+        oversampling->setValueNotifyingHost (oversampling->convertTo0to1 ((float) choice));
+
+        // The first block after the change switches the factor and leaves the new
+        // latency for the message thread: it must not allocate either
+        for (int block = 0; block < 2; ++block)
+        {
+            const auto numAllocations = [&] {
+                ScopedAllocationGuard guard;
+                plugin.processBlock (buffer, midi);
+                return guard.getNumAllocations();
+            }();
+
+            INFO ("oversampling choice " << choice << ", block " << block);
+            CHECK (numAllocations == 0);
+        }
+    }
+}
+
+TEST_CASE ("Oversampling latency is reported to the host", "[realtime]")
+{
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, 512);
+    CHECK (plugin.getLatencySamples() == 0);
+
+    auto* oversampling = plugin.apvts.getParameter ("OVERSAMPLING");
+    oversampling->setValueNotifyingHost (oversampling->convertTo0to1 (2.0f));
+    plugin.prepareToPlay (48000.0, 512);
+    const auto latency = plugin.getLatencySamples();
+    CHECK (latency > 0);
+
+    // A live change reaches the host once the message thread has picked it up
+    juce::AudioBuffer<float> buffer (2, 512);
+    buffer.clear();
+    juce::MidiBuffer midi;
+
+    oversampling->setValueNotifyingHost (oversampling->convertTo0to1 (1.0f));
+    plugin.processBlock (buffer, midi);
+    CHECK (plugin.getLatencySamples() == latency);
+    plugin.applyPendingChanges();
+    CHECK (plugin.getLatencySamples() > 0);
+    CHECK (plugin.getLatencySamples() < latency);
+
+    oversampling->setValueNotifyingHost (oversampling->convertTo0to1 (0.0f));
+    plugin.processBlock (buffer, midi);
+    plugin.applyPendingChanges();
+    CHECK (plugin.getLatencySamples() == 0);
+
+    // Offline rendering can ask for a different factor than live playback
+    auto* render = plugin.apvts.getParameter ("OVERSAMPLING_RENDER");
+    render->setValueNotifyingHost (render->convertTo0to1 (1.0f)); // Off
+    plugin.setNonRealtime (true);
+    plugin.prepareToPlay (48000.0, 512);
+    CHECK (plugin.getLatencySamples() == 0);
+}
+
+TEST_CASE ("Linear phase is prepared on first selection, then reported to the host", "[realtime]")
+{
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, 512);
+
+    juce::AudioBuffer<float> buffer (2, 512);
+    buffer.clear();
+    juce::MidiBuffer midi;
+
+    auto* mode = plugin.apvts.getParameter ("CROSSOVER_MODE");
+    mode->setValueNotifyingHost (1.0f);
+
+    // The audio thread stays on the IIR crossover until the message thread has built the FIR
+    plugin.processBlock (buffer, midi);
+    plugin.applyPendingChanges();
+    CHECK (plugin.getLatencySamples() == 0);
+
+    plugin.processBlock (buffer, midi);
+    plugin.applyPendingChanges();
+    CHECK (plugin.getLatencySamples() == LinearPhaseCrossover::getLatencySamples());
+}
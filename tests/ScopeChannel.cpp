@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include <dsp/ScopeChannel.h>
+
+namespace
+{
+    void pushRamp (ScopeChannel& channel, float start)
+    {
+        juce::AudioBuffer<float> block (2, 5);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < block.getNumSamples(); ++i)
+                block.setSample (ch, i, start + (float) i);
+
+        channel.push (block);
+    }
+}
+
+TEST_CASE ("ScopeChannel hands pushed samples to the consumer in order", "[scope]")
+{
+    ScopeChannel channel (2, 64);
+    channel.setConsumerActive (true);
+
+    pushRamp (channel, 0.0f);
+    pushRamp (channel, 5.0f);
+    pushRamp (channel, 10.0f);
+
+    juce::AudioBuffer<float> destination (2, 32);
+    REQUIRE (channel.read (destination) == 15);
+    for (int i = 0; i < 15; ++i)
+        CHECK (destination.getSample (1, i) == (float) i);
+
+    CHECK (channel.read (destination) == 0);
+
+    pushRamp (channel, 15.0f);
+    REQUIRE (channel.read (destination) == 5);
+    CHECK (destination.getSample (0, 0) == 15.0f);
+    CHECK (destination.getSample (0, 4) == 19.0f);
+}
+
+TEST_CASE ("ScopeChannel gives a lagging consumer the newest samples", "[scope]")
+{
+    // Room for 31 samples: the ramps from 0 to 39 overfill it
+    ScopeChannel channel (2, 32);
+    channel.setConsumerActive (true);
+
+    for (int block = 0; block < 8; ++block)
+        pushRamp (channel, 5.0f * (float) block);
+
+    // Only what fitted was queued (0 to 30); the oldest of it is skipped
+    juce::AudioBuffer<float> destination (2, 8);
+    REQUIRE (channel.read (destination) == 8);
+    for (int i = 0; i < 8; ++i)
+    {
+        CHECK (destination.getSample (0, i) == (float) (23 + i));
+        CHECK (destination.getSample (1, i) == (float) (23 + i));
+    }
+
+    CHECK (channel.read (destination) == 0);
+
+    // Once drained, new blocks get through again
+    pushRamp (channel, 100.0f);
+    REQUIRE (channel.read (destination) == 5);
+    CHECK (destination.getSample (0, 0) == 100.0f);
+    CHECK (destination.getSample (0, 4) == 104.0f);
+}
+
+TEST_CASE ("ScopeChannel ignores pushes without a consumer", "[scope]")
+{
+    ScopeChannel channel (2, 64);
+
+    pushRamp (channel, 1.0f);
+    channel.setConsumerActive (true);
+
+    juce::AudioBuffer<float> destination (2, 8);
+    CHECK (channel.read (destination) == 0);
+}
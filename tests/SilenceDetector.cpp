@@ -0,0 +1,42 @@
+#include <catch2/catch_test_macros.hpp>
+#include <dsp/SilenceDetector.h>
+
+TEST_CASE ("SilenceDetector waits for the hold time before reporting silence", "[scope]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+
+    juce::AudioBuffer<float> silence (2, blockSize);
+    silence.clear();
+
+    juce::AudioBuffer<float> sound (2, blockSize);
+    sound.clear();
+    sound.setSample (1, 100, 0.01f);
+
+    SilenceDetector detector;
+    CHECK_FALSE (detector.isSilent());
+
+    // One second of silence, minus one block
+    const int blocksToHold = (int) (SilenceDetector::holdSeconds * sampleRate) / blockSize;
+    for (int i = 0; i < blocksToHold - 1; ++i)
+        detector.update (silence, blockSize, sampleRate);
+
+    CHECK_FALSE (detector.isSilent());
+
+    detector.update (silence, blockSize, sampleRate);
+    CHECK (detector.isSilent());
+
+    // A single sample above the threshold, on either channel, wakes it up
+    detector.update (sound, blockSize, sampleRate);
+    CHECK_FALSE (detector.isSilent());
+
+    // Noise under the threshold still counts as silence
+    juce::AudioBuffer<float> hiss (2, blockSize);
+    hiss.clear();
+    hiss.setSample (0, 10, juce::Decibels::decibelsToGain (SilenceDetector::thresholdDecibels - 6.0f));
+
+    for (int i = 0; i < blocksToHold; ++i)
+        detector.update (hiss, blockSize, sampleRate);
+
+    CHECK (detector.isSilent());
+}
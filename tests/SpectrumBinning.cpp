@@ -0,0 +1,59 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <components/SpectrumBinning.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+TEST_CASE ("SpectrumBinning places a tone in the column of its log-scaled position", "[spectrum]")
+{
+    constexpr int fftSize = 4096;
+    constexpr double sampleRate = 48000.0;
+    constexpr int numColumns = 300;
+
+    // Tone at bin 85 (about 996 Hz)
+    std::vector<float> decibels (fftSize / 2, -100.0f);
+    decibels[85] = -6.0f;
+
+    SpectrumBinning binning;
+    binning.setLayout (numColumns, 20.0f, 20000.0f);
+    binning.setBallistics (0.0001f, 0.3f, 1.5f, 20.0f);
+    binning.update (decibels.data(), fftSize / 2, sampleRate, fftSize, 0.1f);
+
+    const auto& levels = binning.getLevels();
+    REQUIRE ((int) levels.size() == numColumns);
+
+    const auto loudest = (int) (std::max_element (levels.begin(), levels.end()) - levels.begin());
+    const auto frequency = 85.0 * sampleRate / fftSize;
+    const auto expectedColumn = (int) (std::log10 (frequency / 20.0) / 3.0 * numColumns);
+
+    CHECK (std::abs (loudest - expectedColumn) <= 1);
+    CHECK (levels[(size_t) loudest] == Catch::Approx (-6.0f).margin (0.01));
+}
+
+TEST_CASE ("SpectrumBinning releases slowly and holds peaks", "[spectrum]")
+{
+    constexpr int fftSize = 1024;
+    std::vector<float> loud (fftSize / 2, -10.0f);
+    std::vector<float> silent (fftSize / 2, -100.0f);
+
+    SpectrumBinning binning;
+    binning.setLayout (64, 20.0f, 20000.0f);
+    binning.setBallistics (0.0001f, 0.3f, 1.0f, 20.0f);
+
+    binning.update (loud.data(), fftSize / 2, 44100.0, fftSize, 0.02f);
+    CHECK (binning.getLevels()[10] == Catch::Approx (-10.0f).margin (0.01));
+
+    // One frame of silence: the level only decays a little, the peak stays
+    binning.update (silent.data(), fftSize / 2, 44100.0, fftSize, 0.02f);
+    CHECK (binning.getLevels()[10] < -10.0f);
+    CHECK (binning.getLevels()[10] > -20.0f);
+    CHECK (binning.getPeaks()[10] == Catch::Approx (-10.0f).margin (0.01));
+
+    // After the hold time the peak falls back towards the level
+    for (int i = 0; i < 100; ++i)
+        binning.update (silent.data(), fftSize / 2, 44100.0, fftSize, 0.02f);
+
+    CHECK (binning.getPeaks()[10] < -10.0f);
+    CHECK (binning.getPeaks()[10] >= binning.getLevels()[10]);
+}
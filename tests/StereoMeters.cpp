@@ -0,0 +1,76 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <dsp/StereoMeters.h>
+
+namespace
+{
+    // Sums as accumulated by the width kernel for a constant L/R pair
+    StereoMeters::Reading readingFor (float left, float right, float width = 1.0f)
+    {
+        const double a = left + right;
+        const double d = width * (left - right);
+        return StereoMeters::computeReading (a * a, d * d, a * d);
+    }
+}
+
+TEST_CASE ("StereoMeters readings for reference signals", "[meters]")
+{
+    SECTION ("mono")
+    {
+        const auto reading = readingFor (0.5f, 0.5f);
+        CHECK (reading.correlation == Catch::Approx (1.0f));
+        CHECK (reading.balance == Catch::Approx (0.0f).margin (1.0e-6));
+        CHECK (reading.sideToMid == Catch::Approx (0.0f).margin (1.0e-6));
+    }
+
+    SECTION ("opposite polarity")
+    {
+        const auto reading = readingFor (0.5f, -0.5f);
+        CHECK (reading.correlation == Catch::Approx (-1.0f));
+        CHECK (reading.balance == Catch::Approx (0.0f).margin (1.0e-6));
+    }
+
+    SECTION ("left only")
+    {
+        const auto reading = readingFor (0.5f, 0.0f);
+        CHECK (reading.balance == Catch::Approx (-1.0f));
+        CHECK (reading.sideToMid == Catch::Approx (1.0f));
+    }
+
+    SECTION ("width 0 collapses the band to mono")
+    {
+        const auto reading = readingFor (0.5f, 0.0f, 0.0f);
+        CHECK (reading.correlation == Catch::Approx (1.0f));
+        CHECK (reading.balance == Catch::Approx (0.0f).margin (1.0e-6));
+    }
+
+    SECTION ("silence stays neutral")
+    {
+        const auto reading = readingFor (0.0f, 0.0f);
+        CHECK (reading.correlation == 1.0f);
+        CHECK (reading.balance == 0.0f);
+    }
+}
+
+TEST_CASE ("StereoMeters publishes the integrated block sums", "[meters]")
+{
+    StereoMeters meters;
+    meters.prepare (48000.0);
+
+    // Band 2 is hard left for a whole second of 512-sample blocks
+    WidthKernel::BandSums<StereoMeters::maxBands> sums;
+    for (int block = 0; block < 94; ++block)
+    {
+        sums.clear();
+        for (int i = 0; i < 512; ++i)
+        {
+            sums.mid[2] += 1.0f;
+            sums.side[2] += 1.0f;
+            sums.midSide[2] += 1.0f;
+        }
+        meters.publish (sums, 512);
+    }
+
+    CHECK (meters.getReading (2).balance == Catch::Approx (-1.0f));
+    CHECK (meters.getReading (0).correlation == 1.0f);
+}
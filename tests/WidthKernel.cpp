@@ -0,0 +1,255 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <dsp/MonoBass.h>
+#include <dsp/WidthKernel.h>
+
+namespace
+{
+    constexpr size_t numBands = 4;
+
+    // The original per-band mid/side loop followed by a sum of the bands
+    void referenceWidth (const juce::dsp::AudioBlock<float>* bands, const std::array<float, numBands>& widths, float* outLeft, float* outRight, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            outLeft[i] = 0.0f;
+            outRight[i] = 0.0f;
+
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                const float l = bands[b].getSample (0, i);
+                const float r = bands[b].getSample (1, i);
+                const float mid = 0.5f * (l + r);
+                const float side = 0.5f * (l - r) * widths[b];
+                outLeft[i] += mid + side;
+                outRight[i] += mid - side;
+            }
+        }
+    }
+
+    // Random stereo bands in [-1, 1]. Kernel tests that don't need real L/R bands
+    // read channel 0 as the mid and channel 1 as the side.
+    struct RandomBands
+    {
+        std::array<juce::HeapBlock<char>, numBands> storage;
+        std::array<juce::dsp::AudioBlock<float>, numBands> blocks;
+        WidthKernel::BandPointers<numBands> mid, side;
+
+        RandomBands (int numSamples, juce::int64 seed)
+        {
+            juce::Random random (seed);
+
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                blocks[b] = juce::dsp::AudioBlock<float> (storage[b], 2, (size_t) numSamples);
+                for (size_t ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        blocks[b].setSample ((int) ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+                mid[b] = blocks[b].getChannelPointer (0);
+                side[b] = blocks[b].getChannelPointer (1);
+            }
+        }
+    };
+
+    // Copy of L/R bands encoded to mid/side, as the processor feeds the kernel
+    struct EncodedBands
+    {
+        std::array<juce::HeapBlock<char>, numBands> storage;
+        std::array<juce::dsp::AudioBlock<float>, numBands> blocks;
+        WidthKernel::BandPointers<numBands> mid, side;
+
+        EncodedBands (const std::array<juce::dsp::AudioBlock<float>, numBands>& bands)
+        {
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                blocks[b] = juce::dsp::AudioBlock<float> (storage[b], 2, bands[b].getNumSamples());
+                blocks[b].copyFrom (bands[b]);
+                WidthKernel::encode (blocks[b].getChannelPointer (0), blocks[b].getChannelPointer (1), (int) blocks[b].getNumSamples());
+
+                mid[b] = blocks[b].getChannelPointer (0);
+                side[b] = blocks[b].getChannelPointer (1);
+            }
+        }
+    };
+}
+
+TEST_CASE ("Width kernel matches the per-band reference", "[dsp]")
+{
+    constexpr int maxSamples = 1027;
+    const RandomBands bands (maxSamples, 42);
+    const std::array<float, numBands> widths { 0.0f, 0.7f, 1.0f, 2.0f };
+
+    std::vector<float> expectedLeft (maxSamples), expectedRight (maxSamples);
+    referenceWidth (bands.blocks.data(), widths, expectedLeft.data(), expectedRight.data(), maxSamples);
+
+    const EncodedBands encoded (bands.blocks);
+
+    // The extra sample lets us check an output that isn't SIMD aligned
+    std::vector<float> outLeft (maxSamples + 1), outRight (maxSamples + 1);
+
+    auto checkOutput = [&] (const float* l, const float* r, int numSamples) {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            REQUIRE_THAT (l[i], Catch::Matchers::WithinAbs (expectedLeft[(size_t) i], 1.0e-5));
+            REQUIRE_THAT (r[i], Catch::Matchers::WithinAbs (expectedRight[(size_t) i], 1.0e-5));
+        }
+    };
+
+    WidthKernel::BandSums<numBands> sums;
+
+    for (auto numSamples : { 1, 7, 64, maxSamples })
+    {
+        SECTION ("scalar, " + std::to_string (numSamples) + " samples")
+        {
+            WidthKernel::processScalar<numBands> (encoded.mid, encoded.side, widths, outLeft.data(), outRight.data(), numSamples, sums);
+            checkOutput (outLeft.data(), outRight.data(), numSamples);
+        }
+
+        SECTION ("vectorized, " + std::to_string (numSamples) + " samples")
+        {
+            WidthKernel::process<numBands> (encoded.mid, encoded.side, widths, outLeft.data(), outRight.data(), numSamples, sums);
+            checkOutput (outLeft.data(), outRight.data(), numSamples);
+        }
+
+        SECTION ("vectorized, unaligned output, " + std::to_string (numSamples) + " samples")
+        {
+            WidthKernel::process<numBands> (encoded.mid, encoded.side, widths, outLeft.data() + 1, outRight.data() + 1, numSamples, sums);
+            checkOutput (outLeft.data() + 1, outRight.data() + 1, numSamples);
+        }
+    }
+}
+
+TEST_CASE ("Width ramp kernel matches the scalar ramp", "[dsp]")
+{
+    constexpr int numSamples = 67;
+    const RandomBands bands (numSamples, 7);
+
+    const std::array<float, numBands> startWidths { 0.0f, 1.0f, 1.5f, 2.0f };
+    const std::array<float, numBands> increments { 0.01f, 0.0f, -0.02f, -0.005f };
+
+    std::vector<float> expectedLeft (numSamples), expectedRight (numSamples);
+    WidthKernel::BandSums<numBands> expectedSums, sums;
+    WidthKernel::processRampScalar<numBands> (bands.mid, bands.side, startWidths, increments, expectedLeft.data(), expectedRight.data(), 0, numSamples, expectedSums);
+
+    std::vector<float> outLeft (numSamples), outRight (numSamples);
+    WidthKernel::processRamp<numBands> (bands.mid, bands.side, startWidths, increments, outLeft.data(), outRight.data(), numSamples, sums);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        REQUIRE_THAT (outLeft[(size_t) i], Catch::Matchers::WithinAbs (expectedLeft[(size_t) i], 1.0e-5));
+        REQUIRE_THAT (outRight[(size_t) i], Catch::Matchers::WithinAbs (expectedRight[(size_t) i], 1.0e-5));
+    }
+
+    for (size_t b = 0; b < numBands; ++b)
+    {
+        CHECK_THAT (sums.mid[b], Catch::Matchers::WithinRel (expectedSums.mid[b], 1.0e-4f));
+        CHECK_THAT (sums.side[b], Catch::Matchers::WithinRel (expectedSums.side[b], 1.0e-4f));
+        CHECK_THAT (sums.midSide[b], Catch::Matchers::WithinAbs (expectedSums.midSide[b], 1.0e-3));
+    }
+}
+
+TEST_CASE ("Width kernel accumulates the post-width band sums", "[dsp]")
+{
+    constexpr int numSamples = 131;
+    const RandomBands bands (numSamples, 3);
+
+    const std::array<float, numBands> widths { 0.0f, 0.5f, 1.0f, 2.0f };
+
+    std::vector<float> outLeft (numSamples), outRight (numSamples);
+    WidthKernel::BandSums<numBands> sums;
+    WidthKernel::process<numBands> (bands.mid, bands.side, widths, outLeft.data(), outRight.data(), numSamples, sums);
+
+    for (size_t b = 0; b < numBands; ++b)
+    {
+        double midSum = 0.0, sideSum = 0.0, midSideSum = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double a = bands.mid[b][i];
+            const double d = (double) widths[b] * bands.side[b][i];
+            midSum += a * a;
+            sideSum += d * d;
+            midSideSum += a * d;
+        }
+
+        CHECK_THAT (sums.mid[b], Catch::Matchers::WithinRel ((float) midSum, 1.0e-4f));
+        CHECK_THAT (sums.side[b], Catch::Matchers::WithinAbs (sideSum, 1.0e-2));
+        CHECK_THAT (sums.midSide[b], Catch::Matchers::WithinAbs (midSideSum, 1.0e-2));
+    }
+}
+
+TEST_CASE ("Width kernel filters the side the same way in both paths", "[dsp]")
+{
+    constexpr int numSamples = 259;
+    const RandomBands bands (numSamples, 11);
+
+    const std::array<float, numBands> widths { 0.5f, 1.0f, 1.5f, 2.0f };
+
+    MonoBass<float> expectedFilter, filter;
+    for (auto* f : { &expectedFilter, &filter })
+    {
+        f->setTarget (true, 150.0f);
+        f->prepare (48000.0);
+    }
+
+    std::vector<float> expectedLeft (numSamples), expectedRight (numSamples);
+    WidthKernel::BandSums<numBands> expectedSums, sums;
+    WidthKernel::processScalar<numBands> (bands.mid, bands.side, widths, expectedLeft.data(), expectedRight.data(), 0, numSamples, expectedSums, expectedFilter);
+
+    std::vector<float> outLeft (numSamples), outRight (numSamples);
+    WidthKernel::process<numBands> (bands.mid, bands.side, widths, outLeft.data(), outRight.data(), numSamples, sums, filter);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        REQUIRE_THAT (outLeft[(size_t) i], Catch::Matchers::WithinAbs (expectedLeft[(size_t) i], 1.0e-5));
+        REQUIRE_THAT (outRight[(size_t) i], Catch::Matchers::WithinAbs (expectedRight[(size_t) i], 1.0e-5));
+    }
+
+    // The mid isn't filtered: L + R is still twice the plain sum of the bands
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float midSum = 0.0f;
+        for (size_t b = 0; b < numBands; ++b)
+            midSum += bands.mid[b][i];
+
+        REQUIRE_THAT (outLeft[(size_t) i] + outRight[(size_t) i], Catch::Matchers::WithinAbs (2.0f * midSum, 1.0e-4));
+    }
+
+    for (size_t b = 0; b < numBands; ++b)
+        CHECK_THAT (sums.rawSide[b], Catch::Matchers::WithinRel (expectedSums.rawSide[b], 1.0e-4f));
+}
+
+TEST_CASE ("Width kernel reads an unsplit mid as is", "[dsp]")
+{
+    constexpr int numSamples = 133;
+    const RandomBands bands (numSamples, 5);
+
+    // The whole mid, one sample off so that it isn't SIMD aligned
+    std::vector<float> wholeMid (numSamples + 1);
+    for (int i = 0; i < numSamples; ++i)
+        for (size_t b = 0; b < numBands; ++b)
+            wholeMid[(size_t) i + 1] += bands.mid[b][i];
+
+    const std::array<float, numBands> widths { 0.0f, 0.5f, 1.0f, 2.0f };
+
+    std::vector<float> expectedLeft (numSamples), expectedRight (numSamples);
+    WidthKernel::BandSums<numBands> expectedSums, sums;
+    WidthKernel::process<numBands> (bands.mid, bands.side, widths, expectedLeft.data(), expectedRight.data(), numSamples, expectedSums);
+
+    // Written in place over the mid, like the processor does
+    std::vector<float> outRight (numSamples);
+    const WidthKernel::BandPointers<1> unsplitMid { wholeMid.data() + 1 };
+    WidthKernel::process<numBands> (unsplitMid, bands.side, widths, wholeMid.data() + 1, outRight.data(), numSamples, sums);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        REQUIRE_THAT (wholeMid[(size_t) i + 1], Catch::Matchers::WithinAbs (expectedLeft[(size_t) i], 1.0e-5));
+        REQUIRE_THAT (outRight[(size_t) i], Catch::Matchers::WithinAbs (expectedRight[(size_t) i], 1.0e-5));
+    }
+
+    for (size_t b = 0; b < numBands; ++b)
+    {
+        CHECK_THAT (sums.side[b], Catch::Matchers::WithinRel (expectedSums.side[b], 1.0e-4f));
+        CHECK (sums.mid[b] == 0.0f);
+    }
+}
@@ -0,0 +1,83 @@
+#include "allocation_guard.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local int guardDepth = 0;
+    std::atomic<int> numGuardedAllocations { 0 };
+
+    void noteAllocation() noexcept
+    {
+        if (guardDepth > 0)
+            numGuardedAllocations.fetch_add (1, std::memory_order_relaxed);
+    }
+}
+
+ScopedAllocationGuard::ScopedAllocationGuard()
+    : startCount (numGuardedAllocations.load())
+{
+    ++guardDepth;
+}
+
+ScopedAllocationGuard::~ScopedAllocationGuard()
+{
+    --guardDepth;
+}
+
+int ScopedAllocationGuard::getNumAllocations() const
+{
+    return numGuardedAllocations.load() - startCount;
+}
+
+// juce::HeapBlock (and so AudioBuffer) allocates with std::malloc, not operator new.
+// glibc lets the executable interpose malloc, which catches those as well.
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+
+    void* malloc (size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t count, size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_calloc (count, size);
+    }
+
+    void* realloc (void* ptr, size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_realloc (ptr, size);
+    }
+}
+#endif
+
+void* operator new (std::size_t size)
+{
+#if ! defined(__GLIBC__)
+    noteAllocation();
+#endif
+
+    if (auto* ptr = std::malloc (size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete (void* ptr) noexcept
+{
+    std::free (ptr);
+}
+
+void operator delete (void* ptr, std::size_t) noexcept
+{
+    std::free (ptr);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+/* Counts heap allocations made by the current thread while a guard is alive.
+ *
+ * The global operator new/delete (and malloc/calloc/realloc on glibc) are replaced
+ * in allocation_guard.cpp, so this only works inside the Tests executable.
+ *
+ * Example usage:
+ *
+  ScopedAllocationGuard guard;
+  plugin.processBlock (buffer, midi);
+  REQUIRE (guard.getNumAllocations() == 0);
+
+ */
+class ScopedAllocationGuard
+{
+public:
+    ScopedAllocationGuard();
+    ~ScopedAllocationGuard();
+
+    int getNumAllocations() const;
+
+private:
+    int startCount = 0;
+};